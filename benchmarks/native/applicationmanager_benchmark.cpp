@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+// tests/framework
+#include "mock_proc_info.h"
+#include "mock_prompt_session_manager.h"
+#include "mock_settings.h"
+#include "mock_shared_wakelock.h"
+#include "mock_task_controller.h"
+
+#include <Unity/Application/application_manager.h>
+#include <Unity/Application/desktopfileindex.h>
+#include "promptsessionmanager.h"
+
+using namespace qtmir;
+using namespace ::testing;
+
+namespace {
+
+// The same set of fakes as QtMirTest, minus the gtest fixture
+struct ApplicationManagerFixture
+{
+    explicit ApplicationManagerFixture(int startingAppCount)
+    {
+        // Don't fork real child processes as MockTaskController would by default
+        ON_CALL(*taskController, start(_, _)).WillByDefault(Return(true));
+        ON_CALL(*taskController, appIdHasProcessId(_, _)).WillByDefault(Return(false));
+
+        for (int i = 0; i < startingAppCount; ++i) {
+            appIds << QStringLiteral("benchmark-app-%1").arg(i);
+            applicationManager.startApplication(appIds.last());
+        }
+    }
+
+    NiceMock<MockProcInfo> procInfo;
+    NiceMock<MockSharedWakelock> sharedWakelock;
+    NiceMock<MockSettings> settings;
+    std::shared_ptr<NiceMock<mir::scene::MockPromptSessionManager>> stubPromptSessionManager{
+        std::make_shared<NiceMock<mir::scene::MockPromptSessionManager>>()};
+    std::shared_ptr<qtmir::PromptSessionManager> promptSessionManager{
+        std::make_shared<qtmir::PromptSessionManager>(stubPromptSessionManager)};
+    QSharedPointer<TaskController> taskControllerSharedPointer{
+        new NiceMock<MockTaskController>(promptSessionManager)};
+    NiceMock<MockTaskController> *taskController{
+        static_cast<NiceMock<MockTaskController>*>(taskControllerSharedPointer.data())};
+    ApplicationManager applicationManager{taskControllerSharedPointer,
+        QSharedPointer<MockSharedWakelock>(&sharedWakelock, [](MockSharedWakelock *){}),
+        QSharedPointer<ProcInfo>(&procInfo, [](ProcInfo *){}),
+        QSharedPointer<DesktopFileIndex>(new DesktopFileIndex(QStringList())), // empty, never scans
+        QSharedPointer<MockSettings>(&settings, [](MockSettings *){})};
+    QStringList appIds;
+};
+
+} // anonymous namespace
+
+// The new session belongs to the app that was started last, so all starting apps get checked
+static void BM_ApplicationManagerAuthorizeSession(benchmark::State &state)
+{
+    ApplicationManagerFixture fixture(state.range(0));
+
+    const pid_t pid = 4242;
+    ON_CALL(*fixture.taskController, appIdHasProcessId(fixture.appIds.last(), pid)).WillByDefault(Return(true));
+
+    for (auto _ : state) {
+        bool authorized = false;
+        fixture.applicationManager.authorizeSession(pid, authorized);
+        benchmark::DoNotOptimize(authorized);
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ApplicationManagerAuthorizeSession)->RangeMultiplier(4)->Range(4, 256)->Complexity();
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <eventbuilder.h>
+
+#include <QKeyEvent>
+
+#include <mir/events/event_builders.h>
+
+using namespace qtmir;
+namespace mev = mir::events;
+
+namespace {
+
+mir::EventUPtr makeKeyEvent(int64_t time)
+{
+    return mev::make_event(0 /*DeviceID*/, std::chrono::nanoseconds(time), std::vector<uint8_t>(16, 0xaa),
+                           mir_keyboard_action_down, 0x61 /*keysym*/, 30 /*scan code*/,
+                           mir_input_event_modifier_none);
+}
+
+} // anonymous namespace
+
+static void BM_EventBuilderStore(benchmark::State &state)
+{
+    EventBuilder eventBuilder;
+    auto mirEvent = makeKeyEvent(1000);
+    auto iev = mir_event_get_input_event(mirEvent.get());
+
+    ulong qtTimestamp = 0;
+    for (auto _ : state) {
+        eventBuilder.store(iev, ++qtTimestamp);
+    }
+}
+BENCHMARK(BM_EventBuilderStore);
+
+// Store followed by the lookup that rebuilds the Mir event for the client
+static void BM_EventBuilderStoreAndMakeKeyEvent(benchmark::State &state)
+{
+    EventBuilder eventBuilder;
+    auto mirEvent = makeKeyEvent(1000);
+    auto iev = mir_event_get_input_event(mirEvent.get());
+
+    ulong qtTimestamp = 0;
+    for (auto _ : state) {
+        eventBuilder.store(iev, ++qtTimestamp);
+        QKeyEvent keyEvent(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier, 30, 0x61, 0, QStringLiteral("a"));
+        keyEvent.setTimestamp(qtTimestamp);
+        benchmark::DoNotOptimize(eventBuilder.makeMirEvent(&keyEvent));
+    }
+}
+BENCHMARK(BM_EventBuilderStoreAndMakeKeyEvent);
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QTMIR_BENCHMARKS_FAKEWINDOWS_H
+#define QTMIR_BENCHMARKS_FAKEWINDOWS_H
+
+// src/common
+#include "windowmodelnotifier.h"
+
+// miral
+#include <miral/window.h>
+#include <miral/window_info.h>
+
+// mirtest
+#include <mir/test/doubles/stub_session.h>
+#include <mir/test/doubles/stub_surface.h>
+
+#include <mir/scene/surface_creation_parameters.h>
+
+#include <memory>
+#include <vector>
+
+/*
+    A number of distinct MirAL windows, each with its own surface, all from one session
+ */
+struct FakeWindows
+{
+    explicit FakeWindows(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            auto surface = std::make_shared<mir::test::doubles::StubSurface>();
+            const miral::Window window{session, surface};
+            mir::scene::SurfaceCreationParameters spec;
+            infos.emplace_back(window, spec);
+            surfaces.push_back(surface);
+        }
+    }
+
+    // Tells notifier about all windows, which it delivers through queued connections
+    void addTo(qtmir::WindowModelNotifier &notifier) const
+    {
+        for (const auto &info : infos) {
+            Q_EMIT notifier.windowAdded(qtmir::NewWindow{info});
+        }
+    }
+
+    const std::shared_ptr<mir::test::doubles::StubSession> session{std::make_shared<mir::test::doubles::StubSession>()};
+    std::vector<std::shared_ptr<mir::test::doubles::StubSurface>> surfaces;
+    std::vector<miral::WindowInfo> infos;
+};
+
+#endif // QTMIR_BENCHMARKS_FAKEWINDOWS_H
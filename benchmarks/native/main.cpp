@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <QGuiApplication>
+#include <QLoggingCategory>
+
+/*
+    Microbenchmarks of qtmir's hot paths, built on the fakes from tests/framework.
+
+    Run "make native-benchmarks" to get all results in native-benchmarks.json, or run
+    qtmir-native-benchmarks directly to pass any Google Benchmark option.
+ */
+int main(int argc, char **argv)
+{
+    // Several subjects create QWindows or rely on a running Qt application
+    setenv("QT_QPA_PLATFORM", "minimal", 1);
+    QGuiApplication app(argc, argv);
+
+    // Logging would end up dominating the measurements
+    QLoggingCategory::setFilterRules(QStringLiteral("qtmir.*=false"));
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <Unity/Application/proc_info.h>
+
+#include <unistd.h>
+
+using namespace qtmir;
+
+namespace {
+
+// In the format ProcInfo::CommandLine parses: NUL separated, as in /proc/<pid>/cmdline
+QByteArray makeCommandLine(int argumentCount)
+{
+    QByteArray commandLine("/usr/bin/some-app");
+    commandLine.append('\0');
+    for (int i = 0; i < argumentCount; ++i) {
+        commandLine.append("--option-").append(QByteArray::number(i)).append("=value");
+        commandLine.append('\0');
+    }
+    commandLine.append("--desktop_file_hint=/usr/share/applications/some-app.desktop");
+    commandLine.append('\0');
+    return commandLine;
+}
+
+} // anonymous namespace
+
+// Reading and parsing /proc/<pid>/cmdline, as for a process ProcInfo hasn't seen before
+static void BM_ProcInfoReadOwnCommandLine(benchmark::State &state)
+{
+    const pid_t pid = getpid();
+    for (auto _ : state) {
+        ProcInfo procInfo;
+        benchmark::DoNotOptimize(procInfo.commandLine(pid));
+    }
+}
+BENCHMARK(BM_ProcInfoReadOwnCommandLine);
+
+// ProcInfo keeps what it parsed for as long as the process lives, so this only checks it's still the same process
+static void BM_ProcInfoReadOwnCommandLineCached(benchmark::State &state)
+{
+    ProcInfo procInfo;
+    const pid_t pid = getpid();
+    procInfo.commandLine(pid);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(procInfo.commandLine(pid));
+    }
+}
+BENCHMARK(BM_ProcInfoReadOwnCommandLineCached);
+
+static void BM_ProcInfoGetParameter(benchmark::State &state)
+{
+    ProcInfo::CommandLine commandLine{makeCommandLine(state.range(0))};
+    if (commandLine.getParameter("--desktop_file_hint=") != QLatin1String("/usr/share/applications/some-app.desktop")) {
+        state.SkipWithError("command line not parsed as expected");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(commandLine.getParameter("--desktop_file_hint="));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ProcInfoGetParameter)->RangeMultiplier(4)->Range(4, 256)->Complexity();
+
+static void BM_ProcInfoAsStringList(benchmark::State &state)
+{
+    ProcInfo::CommandLine commandLine{makeCommandLine(state.range(0))};
+    if (commandLine.asStringList().count() != state.range(0) + 2) {
+        state.SkipWithError("command line not parsed as expected");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(commandLine.asStringList());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ProcInfoAsStringList)->RangeMultiplier(4)->Range(4, 256)->Complexity();
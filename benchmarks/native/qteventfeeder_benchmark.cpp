@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <inputtrace.h>
+#include <qteventfeeder.h>
+
+#include <QWindow>
+
+#include <mir/events/event_builders.h>
+
+#include <xkbcommon/xkbcommon-keysyms.h>
+
+namespace mev = mir::events;
+
+namespace {
+
+// Swallows everything, so only QtEventFeeder's own work is measured
+class NullQtWindowSystem : public QtEventFeeder::QtWindowSystemInterface
+{
+public:
+    NullQtWindowSystem() { window.setGeometry(0, 0, 1920, 1080); }
+
+    QWindow* getWindowForTouchPoint(const QPoint &) override { return &window; }
+    QWindow* focusedWindow() override { return &window; }
+    void registerTouchDevice(QTouchDevice *) override {}
+    void handleExtendedKeyEvent(QWindow *, ulong, QEvent::Type, int, Qt::KeyboardModifiers,
+                                quint32, quint32, quint32, const QString &, bool, ushort) override {}
+    void handleTouchEvent(QWindow *, ulong, QTouchDevice *,
+                          const QList<struct QWindowSystemInterface::TouchPoint> &points,
+                          Qt::KeyboardModifiers) override { benchmark::DoNotOptimize(points.count()); }
+    void handleMouseEvent(ulong, QPointF, QPointF, Qt::MouseButtons, Qt::KeyboardModifiers) override {}
+    void handleWheelEvent(ulong, QPointF, QPoint, Qt::KeyboardModifiers) override {}
+
+    QWindow window;
+};
+
+mir::EventUPtr makeTouchEvent(int64_t time, int pointCount, MirTouchAction action)
+{
+    auto ev = mev::make_event(0 /*DeviceID*/, std::chrono::nanoseconds(time), std::vector<uint8_t>{},
+                              mir_input_event_modifier_none);
+    for (int i = 0; i < pointCount; ++i) {
+        mev::add_touch(*ev, i, action, mir_touch_tooltype_finger,
+                       100 + 10 * i + (time % 50), 200 + 10 * i, 1.0f, 5, 5, 0);
+    }
+    return ev;
+}
+
+const MirTouchEvent *touchEventOf(const mir::EventUPtr &ev)
+{
+    return mir_input_event_get_touch_event(mir_event_get_input_event(ev.get()));
+}
+
+} // anonymous namespace
+
+// Touch points moving around, as during a pan or pinch gesture
+static void BM_QtEventFeederDispatchTouchMotion(benchmark::State &state)
+{
+    const int pointCount = state.range(0);
+    QtEventFeeder feeder(new NullQtWindowSystem);
+
+    auto down = makeTouchEvent(0, pointCount, mir_touch_action_down);
+    feeder.dispatchTouch(touchEventOf(down));
+
+    std::vector<mir::EventUPtr> moves;
+    for (int i = 0; i < 64; ++i) {
+        moves.push_back(makeTouchEvent(i + 1, pointCount, mir_touch_action_change));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        feeder.dispatchTouch(touchEventOf(moves[i++ % moves.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QtEventFeederDispatchTouchMotion)->Arg(1)->Arg(2)->Arg(5)->Arg(10);
+
+// Includes the xkb keysym to Qt key translation
+static void BM_QtEventFeederDispatchKey(benchmark::State &state)
+{
+    QtEventFeeder feeder(new NullQtWindowSystem);
+
+    const xkb_keysym_t keysyms[] = { XKB_KEY_a, XKB_KEY_Return, XKB_KEY_F5, XKB_KEY_XF86AudioPlay, XKB_KEY_eacute };
+    std::vector<mir::EventUPtr> events;
+    for (auto keysym : keysyms) {
+        events.push_back(mev::make_event(0 /*DeviceID*/, std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+                                         mir_keyboard_action_down, keysym, 0 /*scan code*/,
+                                         mir_input_event_modifier_none));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        auto iev = mir_event_get_input_event(events[i++ % events.size()].get());
+        feeder.dispatchKey(mir_input_event_get_keyboard_event(iev));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QtEventFeederDispatchKey);
+
+/*
+    Replays a recorded input session (see QTMIR_INPUT_TRACE) through QtEventFeeder as fast as possible.
+    The trace to use is given in QTMIR_BENCHMARK_INPUT_TRACE; it is loaded up front, so parsing it
+    is not part of the measurement.
+ */
+static void BM_QtEventFeederReplayInputTrace(benchmark::State &state)
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv("QTMIR_BENCHMARK_INPUT_TRACE"));
+    if (fileName.isEmpty()) {
+        state.SkipWithError("QTMIR_BENCHMARK_INPUT_TRACE is not set");
+        return;
+    }
+
+    qtmir::InputTraceReader reader(fileName);
+    if (!reader.isValid()) {
+        state.SkipWithError("QTMIR_BENCHMARK_INPUT_TRACE is not a valid input trace");
+        return;
+    }
+
+    std::vector<mir::EventUPtr> events;
+    qtmir::replayInputTrace(reader, [&events](const MirEvent &event) {
+        events.push_back(mev::clone_event(event));
+    }, 0 /* as fast as possible */);
+
+    QtEventFeeder feeder(new NullQtWindowSystem);
+
+    for (auto _ : state) {
+        for (const auto &event : events) {
+            feeder.dispatch(*event);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_QtEventFeederReplayInputTrace);
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "fakewindows.h"
+
+#include <Unity/Application/mirsurface.h>
+#include <Unity/Application/surfacemanager.h>
+
+// tests/framework
+#include "fake_session.h"
+#include "mock_sessionmap.h"
+#include "mock_window_controller.h"
+
+#include <QCoreApplication>
+
+using namespace qtmir;
+
+namespace {
+
+struct SurfaceManagerFixture
+{
+    explicit SurfaceManagerFixture(int windowCount)
+        : windows(windowCount)
+    {
+        using namespace ::testing;
+        ON_CALL(sessionMap, findSession(_)).WillByDefault(Return(&fakeSession));
+
+        windows.addTo(notifier);
+        QCoreApplication::sendPostedEvents();
+    }
+
+    NiceMock<MockWindowController> windowController;
+    WindowModelNotifier notifier;
+    NiceMock<MockSessionMap> sessionMap;
+    FakeSession fakeSession;
+    SurfaceManager surfaceManager{&windowController, &notifier, &sessionMap};
+    FakeWindows windows;
+};
+
+} // anonymous namespace
+
+// Worst case lookup, for the window added last
+static void BM_SurfaceManagerFind(benchmark::State &state)
+{
+    SurfaceManagerFixture fixture(state.range(0));
+    const auto &needle = fixture.windows.infos.back();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fixture.surfaceManager.find(needle));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_SurfaceManagerFind)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
+
+// A window notification as it arrives from the window manager, queued connection included
+static void BM_SurfaceManagerWindowMoved(benchmark::State &state)
+{
+    SurfaceManagerFixture fixture(state.range(0));
+    const auto &info = fixture.windows.infos.back();
+
+    int x = 0;
+    for (auto _ : state) {
+        Q_EMIT fixture.notifier.windowMoved(info, QPoint(++x % 100, 0));
+        QCoreApplication::sendPostedEvents();
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_SurfaceManagerWindowMoved)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "fakewindows.h"
+
+#include <Unity/Application/windowmodel.h>
+
+#include <QCoreApplication>
+
+#include <algorithm>
+
+using namespace qtmir;
+
+// Raising the bottom-most window to the top, the most reordering a single raise can cause
+static void BM_WindowModelRaiseBottomWindow(benchmark::State &state)
+{
+    WindowModelNotifier notifier;
+    WindowModel model(&notifier, nullptr);
+    FakeWindows windows(state.range(0));
+    windows.addTo(notifier);
+    QCoreApplication::sendPostedEvents();
+
+    // Windows get added on top, so cycling through them in order always raises the bottom one
+    size_t i = 0;
+    for (auto _ : state) {
+        Q_EMIT notifier.windowsRaised({windows.infos[i++ % windows.infos.size()].window()});
+        QCoreApplication::sendPostedEvents();
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_WindowModelRaiseBottomWindow)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
+
+// Raising all windows at once, reversing the stacking order, as when restoring a workspace
+static void BM_WindowModelRaiseAllWindows(benchmark::State &state)
+{
+    WindowModelNotifier notifier;
+    WindowModel model(&notifier, nullptr);
+    FakeWindows windows(state.range(0));
+    windows.addTo(notifier);
+    QCoreApplication::sendPostedEvents();
+
+    std::vector<miral::Window> order;
+    for (const auto &info : windows.infos) {
+        order.push_back(info.window());
+    }
+
+    for (auto _ : state) {
+        Q_EMIT notifier.windowsRaised(order);
+        QCoreApplication::sendPostedEvents();
+        std::reverse(order.begin(), order.end());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_WindowModelRaiseAllWindows)->RangeMultiplier(4)->Range(4, 1024)->Complexity();
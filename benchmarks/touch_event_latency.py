@@ -22,6 +22,25 @@ import sys
 from common import get_pointing_device
 import report_types
 
+# qtmir input tracepoints, in the order an event goes through them
+INPUT_STAGES = [
+    "qtmirserver:inputEventArrived",
+    "qtmirserver:inputEventDispatch_start",
+    "qtmirserver:inputEventDispatch_end",
+    "qtmir:inputEventConsume_start",
+    "qtmir:inputEventSurfaceConsume",
+    "qtmirserver:inputEventDeliver",
+    "qtmir:inputEventConsume_end",
+]
+
+# Stage pairs to measure: each stage to the next one, plus the whole way from Mir to the client
+INPUT_STAGE_PAIRS = list(zip(INPUT_STAGES, INPUT_STAGES[1:])) + [
+    ("qtmirserver:inputEventArrived", "qtmirserver:inputEventDeliver"),
+]
+
+# MirInputEventType
+INPUT_EVENT_TYPES = {0: "key", 1: "touch", 2: "pointer"}
+
 ####### TEST #######
 
 
@@ -72,10 +91,8 @@ def perform_test():
     client_touch_data_timestamps = {}
     client_touch_data_latency = {}
 
-    qtmir_touch_dispatch_start = {}
-    qtmir_touch_dispatch_end = {}
-    qtmir_touch_consume_start = {}
-    qtmir_touch_consume_end = {}
+    # (pid, event_type, event_time) -> {stage name: trace timestamp}
+    qtmir_input_stages = {}
 
     events = report_types.Events()
 
@@ -94,21 +111,10 @@ def perform_test():
             if pid not in server_touch_data_timestamps: server_touch_data_timestamps[pid] = []
             server_touch_data_timestamps[pid].append(event["event_time"])
 
-        elif event.name == "qtmirserver:touchEventDispatch_start":
-            if pid not in qtmir_touch_dispatch_start: qtmir_touch_dispatch_start[pid] = []
-            qtmir_touch_dispatch_start[pid].append(event.timestamp)
-
-        elif event.name == "qtmirserver:touchEventDispatch_end":
-            if pid not in qtmir_touch_dispatch_end: qtmir_touch_dispatch_end[pid] = []
-            qtmir_touch_dispatch_end[pid].append(event.timestamp)
-
-        elif event.name == "qtmir:touchEventConsume_start":
-            if pid not in qtmir_touch_consume_start: qtmir_touch_consume_start[pid] = []
-            qtmir_touch_consume_start[pid].append(event.timestamp)
-
-        elif event.name == "qtmir:touchEventConsume_end":
-            if pid not in qtmir_touch_consume_end: qtmir_touch_consume_end[pid] = []
-            qtmir_touch_consume_end[pid].append(event.timestamp)
+        elif event.name in INPUT_STAGES:
+            key = (pid, event["event_type"], event["event_time"])
+            if key not in qtmir_input_stages: qtmir_input_stages[key] = {}
+            qtmir_input_stages[key][event.name] = event.timestamp
 
     # LATENCY MEANS
 
@@ -206,61 +212,35 @@ def perform_test():
     else:
         results.add_child(report_types.Error("No client event timestamp data"))
 
-    qtmir_loop_data = []
-    dispatch_data = []
-    consume_data = []
-
-    # TIME BETWEEN TRACEPOINTS
-    dispatch_starts = qtmir_touch_dispatch_start[nested_pid] if nested_pid in qtmir_touch_dispatch_start else []
-    dispatch_ends = qtmir_touch_dispatch_end[nested_pid] if nested_pid in qtmir_touch_dispatch_end else []
-    consume_starts = qtmir_touch_consume_start[nested_pid] if nested_pid in qtmir_touch_consume_start else []
-    consume_ends = qtmir_touch_consume_end[nested_pid] if nested_pid in qtmir_touch_consume_end else []
-
-    # since there's no uniqueness to events, we need to assume all events are 1:1 through system
-    if len(dispatch_starts) > 0 and len(dispatch_starts) == len(dispatch_ends) and len(dispatch_starts) == len(consume_starts) and len(consume_starts) == len(consume_ends):
-        i = 0
-
-        for start in dispatch_starts:
-            dispatch_diff = (dispatch_ends[i] - start) / 1000000.0
-            consume_diff = (consume_ends[i] - consume_starts[i]) / 1000000.0
-            loop_dif = (consume_starts[i] - dispatch_ends[i]) / 1000000.0
-            dispatch_data.append(dispatch_diff);
-            consume_data.append(consume_diff);
-            qtmir_loop_data.append(loop_dif);
-            i=i+1
-
-        qtmir_loop_xml = report_types.ResultsData(
-            "qtmir_eventloop",
-            statistics.mean(qtmir_loop_data),
-            statistics.stdev(qtmir_loop_data),
-            "Time spent in qtmir event loop")
-        for value in qtmir_loop_data:
-            qtmir_loop_xml.add_data(value)
-        results.add_child(qtmir_loop_xml)
-        qtmir_loop_xml.generate_histogram("qtmir_eventloop")
-
-        qtmir_dispatch_xml = report_types.ResultsData(
-            "qtmir_dispatch",
-            statistics.mean(dispatch_data),
-            statistics.stdev(dispatch_data),
-            "Time QteventFeeder spent dispatching event to qt")
-        for value in dispatch_data:
-            qtmir_dispatch_xml.add_data(value)
-        results.add_child(qtmir_dispatch_xml)
-        qtmir_dispatch_xml.generate_histogram("qtmir_dispatch")
-
-        qtmir_consume_xml = report_types.ResultsData(
-            "qtmir_consume",
-            statistics.mean(consume_data),
-            statistics.stdev(consume_data),
-            "Time MirSurfaceItem spent consiming event")
-        for value in consume_data:
-            qtmir_consume_xml.add_data(value)
-        results.add_child(qtmir_consume_xml)
-        qtmir_consume_xml.generate_histogram("qtmir_consume")
-
+    # TIME BETWEEN STAGES
+    # All input tracepoints carry the original Mir event time, which identifies an event across stages
+    stage_data = {}
+    for (pid, event_type, event_time), stages in qtmir_input_stages.items():
+        if pid != nested_pid:
+            continue
+        for (first, second) in INPUT_STAGE_PAIRS:
+            if first in stages and second in stages:
+                key = (event_type, first, second)
+                if key not in stage_data: stage_data[key] = []
+                stage_data[key].append((stages[second] - stages[first]) / 1000000.0)
+
+    if len(stage_data) > 0:
+        for (event_type, first, second), data in sorted(stage_data.items()):
+            if len(data) < 2:
+                continue
+            name = "qtmir_{}_{}_to_{}".format(INPUT_EVENT_TYPES.get(event_type, event_type),
+                                              first.split(":")[1], second.split(":")[1])
+            stage_xml = report_types.ResultsData(
+                name,
+                statistics.mean(data),
+                statistics.stdev(data),
+                "Time between {} and {}".format(first, second))
+            for value in data:
+                stage_xml.add_data(value)
+            results.add_child(stage_xml)
+            stage_xml.generate_histogram(name)
     else:
-        results.add_child(report_types.Error("Cannot calculate QtMir loop data - Dispatch event count did not match surface consume event count"))
+        results.add_child(report_types.Error("No qtmir input stage data"))
 
     results.add_child(events)
     return results
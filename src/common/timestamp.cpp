@@ -1,18 +1,24 @@
-
+#include <atomic>
 #include <chrono>
 #include "timestamp_impl.h"
 
-std::chrono::nanoseconds appStartTime(0);
+// Input events get their timestamps compressed from multiple threads, so the epoch
+// must be set exactly once no matter who gets there first.
+static std::atomic<std::chrono::nanoseconds::rep> appStartTime(0);
 
 void resetStartTime(std::chrono::nanoseconds timestamp)
 {
-	appStartTime = timestamp;
+	appStartTime.store(timestamp.count());
 }
 
 std::chrono::nanoseconds getStartTime(std::chrono::nanoseconds timestamp, bool allowReset)
 {
-	if (allowReset && appStartTime.count() == 0) {
-		resetStartTime(timestamp);
+	auto startTime = appStartTime.load();
+	if (allowReset && startTime == 0) {
+		// On failure startTime gets the value set by whoever won the race
+		if (appStartTime.compare_exchange_strong(startTime, timestamp.count())) {
+			startTime = timestamp.count();
+		}
 	}
-	return appStartTime;
+	return std::chrono::nanoseconds(startTime);
 }
@@ -25,6 +25,9 @@ namespace qtmir {
 // Converts a mir timestamp (in nanoseconds) to and from a timestamp in milliseconds.
 // Qt system events only work with ulong timestamps. On 32bit archs a ulong is 4 bytes long, so the 64 bit nanoseconds
 // will be truncated and skewed. In order to fix this, we truncate the result by using time since "first call"
+//
+// Qt expects those timestamps in milliseconds, so the compressed value is only meant for Qt. Whenever qtmir needs
+// the full resolution time of an input event it should use the original Mir one (see EventBuilder::mirEventTime)
 template<typename T>
 T compressTimestamp(std::chrono::nanoseconds timestamp);
 
@@ -55,6 +55,12 @@ public:
 
     virtual void setWindowConfinementRegions(const QVector<QRect> &regions) = 0;
     virtual void setWindowMargins(Mir::Type windowType, const QMargins &margins) = 0;
+
+    // Direct input: touches on the given window go straight from Mir to the client, skipping the
+    // Qt scene, as long as the shell allows it and they don't start inside a shell gesture region.
+    virtual void setDirectInputWindow(const miral::Window &window, bool enabled) = 0;
+    virtual void setDirectInputAllowed(bool allowed) = 0;
+    virtual void setShellGestureRegions(const QVector<QRect> &regions) = 0;
 };
 
 } // namespace qtmir
@@ -67,12 +67,271 @@ struct ExtraWindowInfo {
 
 std::shared_ptr<ExtraWindowInfo> getExtraInfo(const miral::WindowInfo &windowInfo);
 
+/*
+ * Ordered record of the window model changes made during one MirAL transaction, so they can
+ * cross to the Qt side in one go.
+ *
+ * Until the Qt side seals it, later transactions made up only of moves and resizes are merged
+ * into the change set already in flight. Moves and resizes are last-writer-wins per window, so a
+ * drag that outpaces the GUI thread results in one geometry update per window rather than one
+ * per pointer event.
+ */
+class WindowModelChangeSet
+{
+public:
+    enum Type {
+        WindowAdded,
+        WindowRemoved,
+        WindowReady,
+        WindowMoved,
+        WindowResized,
+        WindowStateChanged,
+        WindowFocusChanged,
+        WindowsRaised,
+        WindowRequestedRaise,
+        WindowMoveResizeStarted,
+        WindowMoveResizeEnded
+    };
+
+    struct Change {
+        Type type{WindowAdded};
+        miral::WindowInfo windowInfo;
+        std::shared_ptr<mir::scene::Surface> surface; // WindowAdded only, see NewWindow
+        QPoint topLeft;
+        QSize size;
+        Mir::State state{Mir::UnknownState};
+        bool focused{false};
+        std::vector<miral::Window> windows; // WindowsRaised only
+
+        NewWindow newWindow() const
+        {
+            NewWindow window;
+            window.windowInfo = windowInfo;
+            window.surface = surface;
+            return window;
+        }
+    };
+
+    bool isEmpty() const { return m_changes.empty(); }
+
+    bool isGeometryOnly() const
+    {
+        for (const auto &change : m_changes) {
+            if (change.type != WindowMoved && change.type != WindowResized) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Only valid once sealed
+    const std::vector<Change> &changes() const { return m_changes; }
+
+    void append(Type type, const miral::WindowInfo &windowInfo)
+    {
+        Change change;
+        change.type = type;
+        change.windowInfo = windowInfo;
+        append(std::move(change));
+    }
+
+    Change &last() { return m_changes.back(); }
+
+    // Called from the Mir side. Fails once the Qt side has started reading this change set, or
+    // if other holds anything but moves and resizes.
+    bool merge(WindowModelChangeSet &other)
+    {
+        if (!other.isGeometryOnly()) {
+            return false;
+        }
+        QMutexLocker locker(&m_mutex);
+        if (m_sealed) {
+            return false;
+        }
+        for (auto &change : other.m_changes) {
+            append(std::move(change));
+        }
+        other.m_changes.clear();
+        return true;
+    }
+
+    // Called from the Qt side before reading changes()
+    void seal() const
+    {
+        QMutexLocker locker(&m_mutex);
+        m_sealed = true;
+    }
+
+private:
+    void append(Change &&change)
+    {
+        if (change.type == WindowMoved || change.type == WindowResized) {
+            const auto window = change.windowInfo.window();
+            for (auto it = m_changes.rbegin(); it != m_changes.rend(); ++it) {
+                if (it->type == change.type && it->windowInfo.window() == window) {
+                    m_changes.erase(std::next(it).base());
+                    break;
+                }
+            }
+        }
+        m_changes.push_back(std::move(change));
+    }
+
+    std::vector<Change> m_changes;
+    mutable QMutex m_mutex;
+    mutable bool m_sealed{false};
+};
+
+using WindowModelChanges = std::shared_ptr<const WindowModelChangeSet>;
+
 class WindowModelNotifier : public QObject
 {
     Q_OBJECT
 public:
     WindowModelNotifier() = default;
 
+    /*
+     * Called by the window management policy, with the MirAL lock held. Changes notified between
+     * beginChanges() and endChanges() are delivered together through changesCommitted(); outside
+     * of that they are emitted individually.
+     *
+     * A transaction of only moves and resizes is merged into the last change set posted, if the
+     * Qt side has not got round to it yet and nothing else has been posted since. Anything else
+     * goes in a change set of its own, so it keeps its place among the other queued signals.
+     */
+    void beginChanges()
+    {
+        m_pendingChanges = std::make_shared<WindowModelChangeSet>();
+    }
+
+    void endChanges()
+    {
+        if (m_pendingChanges && !m_pendingChanges->isEmpty()) {
+            auto inFlight = m_inFlightChanges.lock();
+            if (!inFlight || !inFlight->merge(*m_pendingChanges)) {
+                m_inFlightChanges = m_pendingChanges;
+                Q_EMIT changesCommitted(m_pendingChanges);
+            }
+        }
+        m_pendingChanges.reset();
+    }
+
+    void notifyWindowAdded(const NewWindow &window)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowAdded, window.windowInfo);
+            m_pendingChanges->last().surface = window.surface;
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowAdded(window);
+        }
+    }
+
+    void notifyWindowRemoved(const miral::WindowInfo &window)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowRemoved, window);
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowRemoved(window);
+        }
+    }
+
+    void notifyWindowReady(const miral::WindowInfo &window)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowReady, window);
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowReady(window);
+        }
+    }
+
+    void notifyWindowMoved(const miral::WindowInfo &window, const QPoint topLeft)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowMoved, window);
+            m_pendingChanges->last().topLeft = topLeft;
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowMoved(window, topLeft);
+        }
+    }
+
+    void notifyWindowResized(const miral::WindowInfo &window, const QSize size)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowResized, window);
+            m_pendingChanges->last().size = size;
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowResized(window, size);
+        }
+    }
+
+    void notifyWindowStateChanged(const miral::WindowInfo &window, Mir::State state)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowStateChanged, window);
+            m_pendingChanges->last().state = state;
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowStateChanged(window, state);
+        }
+    }
+
+    void notifyWindowFocusChanged(const miral::WindowInfo &window, bool focused)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowFocusChanged, window);
+            m_pendingChanges->last().focused = focused;
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowFocusChanged(window, focused);
+        }
+    }
+
+    void notifyWindowsRaised(const std::vector<miral::Window> &windows)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowsRaised, miral::WindowInfo());
+            m_pendingChanges->last().windows = windows;
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowsRaised(windows);
+        }
+    }
+
+    void notifyWindowRequestedRaise(const miral::WindowInfo &window)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowRequestedRaise, window);
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowRequestedRaise(window);
+        }
+    }
+
+    void notifyWindowMoveResizeStarted(const miral::WindowInfo &window)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowMoveResizeStarted, window);
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowMoveResizeStarted(window);
+        }
+    }
+
+    void notifyWindowMoveResizeEnded(const miral::WindowInfo &window)
+    {
+        if (m_pendingChanges) {
+            m_pendingChanges->append(WindowModelChangeSet::WindowMoveResizeEnded, window);
+        } else {
+            m_inFlightChanges.reset();
+            Q_EMIT windowMoveResizeEnded(window);
+        }
+    }
+
 Q_SIGNALS: // **Must used Queued Connection or else events will be out of order**
     void windowAdded(const qtmir::NewWindow &window);
     void windowRemoved(const miral::WindowInfo &window);
@@ -83,11 +342,16 @@ Q_SIGNALS: // **Must used Queued Connection or else events will be out of order*
     void windowFocusChanged(const miral::WindowInfo &window, bool focused);
     void windowsRaised(const std::vector<miral::Window> &windows); // results in deep copy when passed over Queued connection:(
     void windowRequestedRaise(const miral::WindowInfo &window);
-    void modificationsStarted();
-    void modificationsEnded();
+    void windowMoveResizeStarted(const miral::WindowInfo &window); // server-side, client-requested
+    void windowMoveResizeEnded(const miral::WindowInfo &window);
+    void changesCommitted(const qtmir::WindowModelChanges &changes);
 
 private:
     Q_DISABLE_COPY(WindowModelNotifier)
+
+    // guarded by the MirAL lock
+    std::shared_ptr<WindowModelChangeSet> m_pendingChanges;
+    std::weak_ptr<WindowModelChangeSet> m_inFlightChanges; // reset once anything is emitted after it
 };
 
 } // namespace qtmir
@@ -95,6 +359,7 @@ private:
 Q_DECLARE_METATYPE(qtmir::NewWindow)
 Q_DECLARE_METATYPE(miral::WindowInfo)
 Q_DECLARE_METATYPE(std::vector<miral::Window>)
+Q_DECLARE_METATYPE(qtmir::WindowModelChanges)
 Q_DECLARE_METATYPE(MirWindowState)
 
 #endif // WINDOWMODELNOTIFIER_H
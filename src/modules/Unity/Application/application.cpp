@@ -29,6 +29,7 @@
 // QPA mirserver
 #include "logging.h"
 #include "initialsurfacesizes.h"
+#include "windowgeometrystore.h"
 
 // Unity API
 #include <unity/shell/application/MirSurfaceInterface.h>
@@ -485,6 +486,8 @@ void Application::removeSession(SessionInterface *session)
     m_sessions.removeAll(session);
 
     InitialSurfaceSizes::remove(session->pid());
+    WindowGeometryStore::removeAppId(session->pid());
+    WindowGeometryStore::save();
 }
 
 void Application::addSession(SessionInterface *newSession)
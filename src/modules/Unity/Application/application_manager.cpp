@@ -19,6 +19,7 @@
 #include "application.h"
 #include "applicationinfo.h"
 #include "dbusfocusinfo.h"
+#include "desktopfileindex.h"
 #include "mirsurfaceinterface.h"
 #include "session.h"
 #include "sharedwakelock.h"
@@ -30,6 +31,7 @@
 // mirserver
 #include "nativeinterface.h"
 #include "logging.h"
+#include "windowgeometrystore.h"
 
 //miral
 #include <miral/application.h>
@@ -114,6 +116,7 @@ ApplicationManager* ApplicationManager::create()
 
     QSharedPointer<TaskController> taskController(new upstart::TaskController());
     QSharedPointer<ProcInfo> procInfo(new ProcInfo());
+    QSharedPointer<DesktopFileIndex> desktopFileIndex(new DesktopFileIndex());
     QSharedPointer<SharedWakelock> sharedWakelock(new SharedWakelock);
     QSharedPointer<Settings> settings(new Settings());
 
@@ -126,6 +129,7 @@ ApplicationManager* ApplicationManager::create()
                                              taskController,
                                              sharedWakelock,
                                              procInfo,
+                                             desktopFileIndex,
                                              settings
                                          );
 
@@ -155,10 +159,12 @@ ApplicationManager::ApplicationManager(
         const QSharedPointer<TaskController>& taskController,
         const QSharedPointer<SharedWakelock>& sharedWakelock,
         const QSharedPointer<ProcInfo>& procInfo,
+        const QSharedPointer<DesktopFileIndex>& desktopFileIndex,
         const QSharedPointer<SettingsInterface>& settings,
         QObject *parent)
     : ApplicationManagerInterface(parent)
     , m_dbusFocusInfo(new DBusFocusInfo(m_applications))
+    , m_desktopFileIndex(desktopFileIndex)
     , m_taskController(taskController)
     , m_procInfo(procInfo)
     , m_sharedWakelock(sharedWakelock)
@@ -549,27 +555,9 @@ QSharedPointer<ApplicationInfo> ApplicationManager::tryFindApp(const pid_t pid)
     qCDebug(QTMIR_APPLICATIONS) << "Trying to find desktop file";
 
     if (desktopFileName.isNull()) {
-        const auto paths = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
-        for (const auto &path: paths) {
-            qWarning() << "searching" << path;
-            QDirIterator it(path, QStringList() << "*.desktop", QDir::Files, QDirIterator::Subdirectories);
-            while (it.hasNext()) {
-                auto file = it.next();
-                QTextStream in (&file);
-                QString line;
-                while (!line.isNull()) {
-                    line = in.readLine();
-                    if (line.contains("exec") && line.contains(info->getExec())) {
-                        qWarning() << "found match for" << info->asStringList()[0] << "as" << file;
-                        desktopFileName = file;
-                        break;
-                    }
-                }
-                if (!desktopFileName.isNull())
-                    break;
-            }
-        if (!desktopFileName.isNull())
-            break;
+        desktopFileName = m_desktopFileIndex->desktopFileForExec(info->getExec());
+        if (!desktopFileName.isNull()) {
+            qCDebug(QTMIR_APPLICATIONS) << "found match for" << info->getExec() << "as" << desktopFileName;
         }
     }
 
@@ -592,21 +580,27 @@ QSharedPointer<ApplicationInfo> ApplicationManager::tryFindApp(const pid_t pid)
 void ApplicationManager::authorizeSession(const pid_t pid, bool &authorized)
 {
     // This is the only function that is called from a different thread than the one
-    // in which the object lives, that's why we use queuedAddApp
-
-    QMutexLocker locker(&m_mutex);
+    // in which the object lives, that's why we use queuedAddApp.
+    // It works off m_authorizationSnapshot instead of taking m_mutex, so that a new client
+    // connection does not have to wait for whatever the GUI thread is doing with the model.
 
     tracepoint(qtmir, authorizeSession);
     authorized = false; //to be proven wrong
 
     qCDebug(QTMIR_APPLICATIONS) << "ApplicationManager::authorizeSession - pid=" << pid;
 
-    Q_FOREACH (Application *app, m_applications) {
-        if (app->state() == Application::Starting) {
+    QHash<QString, bool> startingForAppId;
+    {
+        QMutexLocker locker(&m_authorizationMutex);
+        startingForAppId = m_authorizationSnapshot;
+    }
+
+    for (auto it = startingForAppId.constBegin(); it != startingForAppId.constEnd(); ++it) {
+        if (it.value()) {
             tracepoint(qtmir, appIdHasProcessId_start);
-            if (m_taskController->appIdHasProcessId(app->appId(), pid)) {
+            if (m_taskController->appIdHasProcessId(it.key(), pid)) {
                 authorized = true;
-                m_authorizedPids.insertMulti(pid, app->appId());
+                addAuthorizedPid(pid, it.key());
                 tracepoint(qtmir, appIdHasProcessId_end, 1); //found
                 return;
             }
@@ -642,7 +636,7 @@ void ApplicationManager::authorizeSession(const pid_t pid, bool &authorized)
         qWarning() << nodq->appId() << nodq->supportedOrientations();
         queuedAddApp(nodq, arguments, pid);
         authorized = true;
-        m_authorizedPids.insertMulti(pid, "Xwayland");
+        addAuthorizedPid(pid, QStringLiteral("Xwayland"));
         return;
     }
     
@@ -651,19 +645,39 @@ void ApplicationManager::authorizeSession(const pid_t pid, bool &authorized)
 
     // some naughty applications use a script to launch the actual application. Check for the
     // case where shell actually launched the script.
-    Application *application = findApplicationMutexHeld(appInfo->appId());
-    if (application) {
+    if (startingForAppId.contains(toShortAppIdIfPossible(appInfo->appId()))) {
         qCDebug(QTMIR_APPLICATIONS) << "Process with pid" << pid << "appeared, attaching to existing entry"
-                                    << "in application list with appId:" << application->appId();
+                                    << "in application list with appId:" << appInfo->appId();
         authorized = true;
-        m_authorizedPids.insertMulti(pid, appInfo->appId());
+        addAuthorizedPid(pid, appInfo->appId());
         return;
     }
 
     const QStringList arguments(info->asStringList());
-    queuedAddApp(appInfo, arguments, pid);
     authorized = true;
-    m_authorizedPids.insertMulti(pid, appInfo->appId());
+    addAuthorizedPid(pid, appInfo->appId());
+    queuedAddApp(appInfo, arguments, pid);
+}
+
+void ApplicationManager::addAuthorizedPid(const pid_t pid, const QString &appId)
+{
+    // Now, rather than once the session reaches the GUI thread, as its first window may already be
+    // getting placed by then
+    WindowGeometryStore::setAppId(pid, toShortAppIdIfPossible(appId));
+
+    QMutexLocker locker(&m_authorizationMutex);
+    m_authorizedPids.insertMulti(pid, appId);
+}
+
+void ApplicationManager::updateAuthorizationSnapshot()
+{
+    QHash<QString, bool> startingForAppId;
+    for (Application *application : m_applications) {
+        startingForAppId.insert(application->appId(), application->state() == Application::Starting);
+    }
+
+    QMutexLocker locker(&m_authorizationMutex);
+    m_authorizationSnapshot = startingForAppId;
 }
 
 
@@ -698,6 +712,13 @@ void ApplicationManager::addApp(const QSharedPointer<qtmir::ApplicationInfo> &ap
 {
     QMutexLocker locker(&m_mutex);
 
+    // The application may have been added since authorizeSession looked
+    if (findApplicationMutexHeld(appInfo->appId())) {
+        qCDebug(QTMIR_APPLICATIONS) << "Process with pid" << pid << "appeared, attaching to existing entry"
+                                    << "in application list with appId:" << appInfo->appId();
+        return;
+    }
+
     qCDebug(QTMIR_APPLICATIONS) << "New process with pid" << pid << "appeared, adding new application to the"
                                 << "application list with appId:" << appInfo->appId();
 
@@ -740,7 +761,10 @@ void ApplicationManager::add(Application* application)
         Q_EMIT focusedApplicationIdChanged();
     }, Qt::QueuedConnection);
 
-    connect(application, &Application::stateChanged, this, [this](Application::State) { onAppDataChanged(RoleState); });
+    connect(application, &Application::stateChanged, this, [this](Application::State) {
+        updateAuthorizationSnapshot();
+        onAppDataChanged(RoleState);
+    });
     connect(application, &Application::closing, this, [this, application]() { onApplicationClosing(application); });
     connect(application, &unityapi::ApplicationInfoInterface::focusRequested, this, [this, application]() {
         Q_EMIT focusRequested(application->appId());
@@ -778,6 +802,7 @@ void ApplicationManager::add(Application* application)
     beginInsertRows(QModelIndex(), m_applications.count(), m_applications.count());
     m_applications.append(application);
     endInsertRows();
+    updateAuthorizationSnapshot();
     Q_EMIT countChanged();
 
     m_modelUnderChange = false;
@@ -803,6 +828,7 @@ void ApplicationManager::remove(Application *application)
     beginRemoveRows(QModelIndex(), index, index);
     m_applications.removeAt(index);
     endRemoveRows();
+    updateAuthorizationSnapshot();
     Q_EMIT countChanged();
 
     disconnect(application, &Application::fullscreenChanged, this, 0);
@@ -859,8 +885,11 @@ void ApplicationManager::onSessionStarting(SessionInterface *qmlSession)
 {
     QMutexLocker locker(&m_mutex);
 
+    m_dbusFocusInfo->invalidateSessions();
+
     Application* application = nullptr;
     {
+        QMutexLocker authorizationLocker(&m_authorizationMutex);
         auto iter = m_authorizedPids.find(miral::pid_of(qmlSession->session()));
         if (iter != m_authorizedPids.end()) {
             QString appId = iter.value();
@@ -51,6 +51,7 @@ namespace unity {
 namespace qtmir {
 
 class DBusFocusInfo;
+class DesktopFileIndex;
 class DBusWindowStack;
 class ProcInfo;
 class SharedWakelock;
@@ -70,6 +71,7 @@ public:
             const QSharedPointer<TaskController> &taskController,
             const QSharedPointer<SharedWakelock> &sharedWakelock,
             const QSharedPointer<ProcInfo> &processInfo,
+            const QSharedPointer<DesktopFileIndex> &desktopFileIndex,
             const QSharedPointer<SettingsInterface> &settings,
             QObject *parent = 0);
     virtual ~ApplicationManager();
@@ -124,9 +126,12 @@ private:
     Application* findApplicationWithPromptSession(const mir::scene::PromptSession* promptSession);
     Application *findClosingApplication(const QString &inputAppId) const;
     QSharedPointer<qtmir::ApplicationInfo> tryFindApp(const pid_t pid);
+    void addAuthorizedPid(const pid_t pid, const QString &appId);
+    void updateAuthorizationSnapshot();
 
     QList<Application*> m_applications;
     DBusFocusInfo *m_dbusFocusInfo;
+    QSharedPointer<DesktopFileIndex> m_desktopFileIndex;
     QSharedPointer<TaskController> m_taskController;
     QSharedPointer<ProcInfo> m_procInfo;
     QSharedPointer<SharedWakelock> m_sharedWakelock;
@@ -136,9 +141,12 @@ private:
     bool m_modelUnderChange{false};
     static ApplicationManager* the_application_manager;
 
-    QHash<pid_t, QString> m_authorizedPids;
-
     mutable QMutex m_mutex;
+
+    // What authorizeSession needs to know, for it to not wait on m_mutex
+    QMutex m_authorizationMutex;
+    QHash<pid_t, QString> m_authorizedPids;
+    QHash<QString, bool> m_authorizationSnapshot; // appId -> whether in Application::Starting state
 };
 
 } // namespace qtmir
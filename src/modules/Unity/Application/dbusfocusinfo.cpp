@@ -17,7 +17,6 @@
 #include "dbusfocusinfo.h"
 
 // local
-#include "cgmanager.h"
 #include "mirsurfacelistmodel.h"
 #include "mirsurfaceinterface.h"
 #include "session_interface.h"
@@ -27,16 +26,70 @@
 #include <shelluuid.h>
 
 #include <QDBusConnection>
+#include <QFile>
 
 using namespace qtmir;
 
+namespace {
+
+// Unit ubuntu-app-launch's systemd backend runs an application in, eg. app-gedit-1234.scope
+bool isApplicationUnit(const QByteArray &name)
+{
+    return (name.startsWith("app-") || name.startsWith("ubuntu-app-launch-"))
+            && (name.endsWith(".scope") || name.endsWith(".service"));
+}
+
+QString applicationCgroupOfPid(pid_t pid)
+{
+    QFile file(QStringLiteral("/proc/%1/cgroup").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    return DBusFocusInfo::applicationCgroup(file.readAll());
+}
+
+} // anonymous namespace
+
+/*
+  Processes in the cgroup returned all belong to a single application. That is an upstart job in
+  the freezer hierarchy, eg.
+    /user.slice/user-32011.slice/session-c3.scope/upstart/application-legacy-puritine_gedit_0.0-
+  or, failing that, a systemd unit in the unified (v2) hierarchy, eg.
+    /user.slice/user-1000.slice/user@1000.service/app.slice/app-gedit-1234.scope
+ */
+QString DBusFocusInfo::applicationCgroup(const QByteArray &procPidCgroup)
+{
+    QByteArray freezerCgroup;
+    QByteArray unifiedCgroup;
+    for (const QByteArray &line : procPidCgroup.split('\n')) {
+        // hierarchy-ID:controller-list:cgroup-path
+        const int firstColon = line.indexOf(':');
+        const int secondColon = line.indexOf(':', firstColon + 1);
+        if (firstColon < 0 || secondColon < 0) {
+            continue;
+        }
+        const QByteArray controllers = line.mid(firstColon + 1, secondColon - firstColon - 1);
+        if (controllers.split(',').contains("freezer")) {
+            freezerCgroup = line.mid(secondColon + 1);
+        } else if (controllers.isEmpty() && line.startsWith("0:")) {
+            unifiedCgroup = line.mid(secondColon + 1);
+        }
+    }
+
+    if (freezerCgroup.split('/').contains("upstart")) {
+        return QString::fromUtf8(freezerCgroup);
+    }
+    if (isApplicationUnit(unifiedCgroup.mid(unifiedCgroup.lastIndexOf('/') + 1))) {
+        return QString::fromUtf8(unifiedCgroup);
+    }
+    return QString();
+}
+
 DBusFocusInfo::DBusFocusInfo(const QList<Application*> &applications)
     : m_applications(applications)
 {
     QDBusConnection::sessionBus().registerService("com.canonical.Unity.FocusInfo");
     QDBusConnection::sessionBus().registerObject("/com/canonical/Unity/FocusInfo", this, QDBusConnection::ExportScriptableSlots);
-
-    m_cgManager = new CGManager(this);
 }
 
 bool DBusFocusInfo::isPidFocused(unsigned int pid)
@@ -46,52 +99,59 @@ bool DBusFocusInfo::isPidFocused(unsigned int pid)
         // Don't bother checking if it has a QML with activeFocus() which is not a MirSurfaceItem.
         return true;
     } else {
-        auto pidSet = fetchAssociatedPids((pid_t)pid);
-        SessionInterface *session = findSessionWithPid(pidSet);
+        SessionInterface *session = findSessionWithPid((pid_t)pid);
         return session ? session->activeFocus() : false;
     }
 }
 
-QSet<pid_t> DBusFocusInfo::fetchAssociatedPids(pid_t pid)
+void DBusFocusInfo::invalidateSessions()
 {
-    QString cgroup = m_cgManager->getCGroupOfPid("freezer", pid);
-
-    // If a cgroup has a format like this:
-    // /user.slice/user-32011.slice/session-c3.scope/upstart/application-legacy-puritine_gedit_0.0-
-    // All PIds in it are associated with a single application.
-    if (cgroup.split("/").contains("upstart")) {
-        QSet<pid_t> pidSet = m_cgManager->getTasks("freezer", cgroup);
-        qCDebug(QTMIR_DBUS) << "DBusFocusInfo: pid" << pid << "is in cgroup" << cgroup << "along with:" << pidSet;
-        if (pidSet.isEmpty()) {
-            pidSet << pid;
-        }
-        return pidSet;
-    } else {
-        qCDebug(QTMIR_DBUS) << "DBusFocusInfo: pid" << pid << "is in cgroup" << cgroup << "which is not app-specific";
-        return QSet<pid_t>({pid});
+    m_sessionsIndexed = false;
+}
+
+SessionInterface* DBusFocusInfo::findSessionWithPid(pid_t pid)
+{
+    if (!m_sessionsIndexed) {
+        indexSessions();
+    }
+
+    // All pids in an application-specific cgroup are associated with that application's session
+    const QString cgroup = applicationCgroupOfPid(pid);
+    SessionInterface *session = cgroup.isNull() ? nullptr : m_sessionForCgroup.value(cgroup).data();
+    if (!session) {
+        session = m_sessionForPid.value(pid);
     }
+    qCDebug(QTMIR_DBUS) << "DBusFocusInfo: pid" << pid << "is in cgroup" << cgroup << "of session" << session;
+    return session;
 }
 
-SessionInterface* DBusFocusInfo::findSessionWithPid(const QSet<pid_t> &pidSet)
+void DBusFocusInfo::indexSessions()
 {
-    Q_FOREACH (Application* application, m_applications) {
-        QVector<SessionInterface*> sessions = application->sessions();
-        for (auto session : sessions) {
-            if (pidSet.contains(session->pid())) {
-                return session;
-            }
-            SessionInterface *chosenChildSession = nullptr;
+    m_sessionForPid.clear();
+    m_sessionForCgroup.clear();
+
+    // Earlier sessions win, when several share a pid or cgroup
+    auto add = [this](SessionInterface *session) {
+        if (!m_sessionForPid.contains(session->pid())) {
+            m_sessionForPid.insert(session->pid(), session);
+        }
+        const QString cgroup = applicationCgroupOfPid(session->pid());
+        if (!cgroup.isNull() && !m_sessionForCgroup.contains(cgroup)) {
+            m_sessionForCgroup.insert(cgroup, session);
+        }
+        connect(session, &QObject::destroyed, this, &DBusFocusInfo::invalidateSessions, Qt::UniqueConnection);
+    };
+
+    for (Application* application : m_applications) {
+        for (SessionInterface *session : application->sessions()) {
+            add(session);
             session->foreachChildSession([&](SessionInterface* childSession) {
-                if (pidSet.contains(childSession->pid())) {
-                    chosenChildSession = childSession;
-                }
+                add(childSession);
             });
-            if (chosenChildSession) {
-                return chosenChildSession;
-            }
         }
     }
-    return nullptr;
+
+    m_sessionsIndexed = true;
 }
 
 bool DBusFocusInfo::isSurfaceFocused(const QString &serializedId)
@@ -14,14 +14,15 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QByteArray>
+#include <QHash>
 #include <QList>
-#include <QSet>
+#include <QPointer>
 
 #include "application.h"
 
 namespace qtmir {
 
-class CGManager;
 class MirSurfaceInterface;
 
 /*
@@ -36,6 +37,12 @@ public:
     explicit DBusFocusInfo(const QList<Application*> &applications);
     virtual ~DBusFocusInfo() {}
 
+    // To be called when sessions start, for isPidFocused to know about them
+    void invalidateSessions();
+
+    // The application-specific cgroup in the given contents of /proc/<pid>/cgroup, or a null string
+    static QString applicationCgroup(const QByteArray &procPidCgroup);
+
 public Q_SLOTS:
 
     /*
@@ -52,13 +59,16 @@ public Q_SLOTS:
     Q_SCRIPTABLE bool isSurfaceFocused(const QString &surfaceId);
 
 private:
-    QSet<pid_t> fetchAssociatedPids(pid_t pid);
-    SessionInterface* findSessionWithPid(const QSet<pid_t> &pidSet);
+    SessionInterface* findSessionWithPid(pid_t pid);
+    void indexSessions();
     MirSurfaceInterface *findQmlSurface(const QString &serializedId);
 
     const QList<Application*> &m_applications;
 
-    CGManager *m_cgManager;
+    // Built on demand from m_applications, dropped whenever a session starts or goes away
+    bool m_sessionsIndexed{false};
+    QHash<pid_t, QPointer<SessionInterface>> m_sessionForPid;
+    QHash<QString, QPointer<SessionInterface>> m_sessionForCgroup; // only of application-specific cgroups
 };
 
 } // namespace qtmir
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "desktopfileindex.h"
+#include "logging.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QReadLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <QWriteLocker>
+
+using namespace qtmir;
+
+namespace {
+
+const quint32 cacheVersion = 1;
+
+QString cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+            + QStringLiteral("/qtmir/desktopfiles.cache");
+}
+
+// File name of the program an Exec value runs, skipping any "env VAR=value" prefix
+QString execFileName(const QString &exec)
+{
+    const QStringList tokens = exec.split(QLatin1Char(' '), QString::SkipEmptyParts);
+    bool afterEnv = false;
+    for (QString token : tokens) {
+        if (token.startsWith(QLatin1Char('"')) && token.endsWith(QLatin1Char('"')) && token.size() > 1) {
+            token = token.mid(1, token.size() - 2);
+        }
+        if (token == QLatin1String("env") || token.endsWith(QLatin1String("/env"))) {
+            afterEnv = true;
+            continue;
+        }
+        if (afterEnv && token.contains(QLatin1Char('='))) {
+            continue;
+        }
+        return QFileInfo(token).fileName();
+    }
+    return QString();
+}
+
+// The Exec value of the [Desktop Entry] group of a desktop file
+QString readExec(const QString &desktopFilePath)
+{
+    QFile file(desktopFilePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QString();
+    }
+
+    bool inDesktopEntry = false;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.startsWith('[')) {
+            if (inDesktopEntry) {
+                break;
+            }
+            inDesktopEntry = (line == "[Desktop Entry]");
+        } else if (inDesktopEntry && line.startsWith("Exec=")) {
+            return QString::fromUtf8(line.mid(5));
+        }
+    }
+    return QString();
+}
+
+} // anonymous namespace
+
+class DesktopFileIndex::Scanner : public QThread
+{
+public:
+    explicit Scanner(const QStringList &applicationsPaths)
+        : m_applicationsPaths(applicationsPaths)
+    {}
+
+    void run() override
+    {
+        m_desktopFileForExec.clear();
+        m_directories.clear();
+
+        // Earlier paths take precedence, as per the XDG base directory spec
+        for (const QString &path : m_applicationsPaths) {
+            if (!QFileInfo(path).isDir()) {
+                continue;
+            }
+            m_directories << path;
+
+            QDirIterator it(path, QStringList() << QStringLiteral("*.desktop"), QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                const QString desktopFile = it.next();
+                const QString directory = it.fileInfo().absolutePath();
+                if (!m_directories.contains(directory)) {
+                    m_directories << directory;
+                }
+
+                const QString exec = execFileName(readExec(desktopFile));
+                if (!exec.isEmpty() && !m_desktopFileForExec.contains(exec)) {
+                    m_desktopFileForExec.insert(exec, desktopFile);
+                }
+            }
+        }
+
+        saveCache();
+    }
+
+    // Only to be read once the thread has finished
+    QHash<QString, QString> m_desktopFileForExec;
+    QStringList m_directories;
+
+private:
+    void saveCache() const
+    {
+        const QString path = cacheFilePath();
+        QDir().mkpath(QFileInfo(path).absolutePath());
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return;
+        }
+        QDataStream stream(&file);
+        stream << cacheVersion << m_applicationsPaths << m_desktopFileForExec;
+        file.commit();
+    }
+
+    const QStringList m_applicationsPaths;
+};
+
+DesktopFileIndex::DesktopFileIndex(const QStringList &applicationsPaths, QObject *parent)
+    : QObject(parent)
+    , m_applicationsPaths(applicationsPaths)
+    , m_scanner(new Scanner(applicationsPaths))
+{
+    if (m_applicationsPaths.isEmpty()) {
+        return;
+    }
+
+    loadCache();
+
+    connect(m_scanner, &QThread::finished, this, &DesktopFileIndex::onScanFinished);
+
+    // Desktop files tend to be installed several at a time
+    m_rescanTimer.setSingleShot(true);
+    m_rescanTimer.setInterval(500);
+    connect(&m_rescanTimer, &QTimer::timeout, this, &DesktopFileIndex::rescan);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, &m_rescanTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+
+    rescan();
+}
+
+DesktopFileIndex::~DesktopFileIndex()
+{
+    m_scanner->wait();
+    delete m_scanner;
+}
+
+QString DesktopFileIndex::desktopFileForExec(const QString &exec) const
+{
+    QReadLocker locker(&m_lock);
+    return m_desktopFileForExec.value(QFileInfo(exec).fileName());
+}
+
+void DesktopFileIndex::rescan()
+{
+    // Not isRunning(): the scanner's results are only taken in onScanFinished(), which runs a while
+    // after the thread has finished, and a new scan must not overwrite them before then
+    if (m_scanning) {
+        m_rescanPending = true;
+        return;
+    }
+    m_scanning = true;
+    m_scanner->start(QThread::LowPriority);
+}
+
+void DesktopFileIndex::onScanFinished()
+{
+    m_scanning = false;
+    {
+        QWriteLocker locker(&m_lock);
+        m_desktopFileForExec = m_scanner->m_desktopFileForExec;
+    }
+    qCDebug(QTMIR_APPLICATIONS) << "DesktopFileIndex: indexed" << m_desktopFileForExec.count() << "desktop files";
+
+    const QStringList watched = m_watcher.directories();
+    if (!watched.isEmpty()) {
+        m_watcher.removePaths(watched);
+    }
+    if (!m_scanner->m_directories.isEmpty()) {
+        m_watcher.addPaths(m_scanner->m_directories);
+    }
+
+    Q_EMIT updated();
+
+    if (m_rescanPending) {
+        m_rescanPending = false;
+        rescan();
+    }
+}
+
+void DesktopFileIndex::loadCache()
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 version;
+    QStringList applicationsPaths;
+    QHash<QString, QString> desktopFileForExec;
+    stream >> version;
+    if (version != cacheVersion) {
+        return;
+    }
+    stream >> applicationsPaths >> desktopFileForExec;
+    if (stream.status() != QDataStream::Ok || applicationsPaths != m_applicationsPaths) {
+        return;
+    }
+
+    QWriteLocker locker(&m_lock);
+    m_desktopFileForExec = desktopFileForExec;
+}
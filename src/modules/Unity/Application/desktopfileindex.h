@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DESKTOPFILEINDEX_H
+#define DESKTOPFILEINDEX_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTimer>
+
+namespace qtmir {
+
+/*
+  Maps the executable an application's desktop file launches to that desktop file.
+
+  It starts off with what was found on the previous run, if anything, then rescans the
+  applications directories in a background thread, and again whenever they change.
+  Given no directories, it stays empty and never touches the disk.
+ */
+class DesktopFileIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DesktopFileIndex(const QStringList &applicationsPaths
+                                  = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation),
+                              QObject *parent = nullptr);
+    ~DesktopFileIndex();
+
+    // Path of the desktop file whose Exec line runs exec (compared by file name), or a null string.
+    // Can be called from any thread.
+    QString desktopFileForExec(const QString &exec) const;
+
+Q_SIGNALS:
+    // A scan of the applications directories finished
+    void updated();
+
+private Q_SLOTS:
+    void rescan();
+    void onScanFinished();
+
+private:
+    class Scanner;
+
+    void loadCache();
+
+    const QStringList m_applicationsPaths;
+    Scanner *m_scanner;
+    bool m_scanning{false}; // until onScanFinished() has taken the results
+    bool m_rescanPending{false};
+    QFileSystemWatcher m_watcher;
+    QTimer m_rescanTimer;
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, QString> m_desktopFileForExec;
+
+    Q_DISABLE_COPY(DesktopFileIndex)
+};
+
+} // namespace qtmir
+
+#endif // DESKTOPFILEINDEX_H
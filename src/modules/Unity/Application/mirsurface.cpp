@@ -21,6 +21,7 @@
 #include "session_interface.h"
 #include "timer.h"
 #include "timestamp.h"
+#include "tracepoints.h" // generated from tracepoints.tp
 #include "application.h"
 
 // from common dir
@@ -78,6 +79,12 @@ qint64 msecsSinceReference()
     return elapsedTimer.msecsSinceReference();
 }
 
+void traceSurfaceConsume(const mir::EventUPtr &ev)
+{
+    auto iev = mir_event_get_input_event(ev.get());
+    tracepoint(qtmir, inputEventSurfaceConsume, mir_input_event_get_type(iev), mir_input_event_get_event_time(iev));
+}
+
 } // namespace {
 
 class MirSurface::SurfaceObserverImpl : public SurfaceObserver, public mir::scene::SurfaceObserver
@@ -160,6 +167,11 @@ public:
 
 private:
     QCursor createQCursorFromMirCursorImage(const mir::graphics::CursorImage &cursorImage);
+    void recordName(const char *name);
+    void recordCursor(const QCursor &cursor);
+    void recordAttribute(MirWindowAttrib attribute, int value);
+    void recordHidden(bool hide);
+
     QObject *m_listener;
     bool m_framesPosted;
     QMap<QByteArray, Qt::CursorShape> m_cursorNameToShape;
@@ -209,22 +221,9 @@ MirSurface::MirSurface(NewWindow newWindowInfo,
     m_surface->add_observer(m_surfaceObserver);
 
     connect(m_surfaceObserver.get(), &SurfaceObserver::framesPosted, this, &MirSurface::onFramesPostedObserved);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::attributeChanged, this, &MirSurface::onAttributeChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::nameChanged, this, &MirSurface::onNameChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::cursorChanged, this, &MirSurface::setCursor);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::hiddenChanged, this, &MirSurface::updateVisible);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::minimumWidthChanged, this, &MirSurface::onMinimumWidthChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::minimumHeightChanged, this, &MirSurface::onMinimumHeightChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::maximumWidthChanged, this, &MirSurface::onMaximumWidthChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::maximumHeightChanged, this, &MirSurface::onMaximumHeightChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::widthIncrementChanged, this, &MirSurface::onWidthIncrementChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::heightIncrementChanged, this, &MirSurface::onHeightIncrementChanged);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::shellChromeChanged, this, [&](MirShellChrome shell_chrome) {
-        setShellChrome(toQtShellChrome(shell_chrome));
-    });
-    connect(m_surfaceObserver.get(), &SurfaceObserver::inputBoundsChanged, this, &MirSurface::setInputBounds);
-    connect(m_surfaceObserver.get(), &SurfaceObserver::confinesMousePointerChanged, this, &MirSurface::confinesMousePointerChanged);
+    connect(m_surfaceObserver.get(), &SurfaceObserver::changesPending, this, &MirSurface::onSurfaceChangesPending);
     m_surfaceObserver->setListener(this);
+    onSurfaceChangesPending(); // anything observed before we were listening
 
     connect(session, &SessionInterface::stateChanged, this, [this]() {
         if (clientIsRunning() && m_pendingResize.isValid()) {
@@ -264,6 +263,10 @@ MirSurface::~MirSurface()
 
     Q_ASSERT(m_views.isEmpty());
 
+    if (m_directInput) {
+        m_controller->setDirectInputWindow(m_window, false);
+    }
+
     QMutexLocker locker(&m_mutex);
     m_surface->remove_observer(m_surfaceObserver);
 
@@ -280,6 +283,54 @@ void MirSurface::onFramesPostedObserved()
     Q_EMIT framesPosted();
 }
 
+void MirSurface::onSurfaceChangesPending()
+{
+    const SurfaceObserverChanges changes = m_surfaceObserver->takeChanges();
+    if (changes.isEmpty()) {
+        return;
+    }
+
+    for (const auto &attribute : changes.attributes) {
+        onAttributeChanged(attribute.first, attribute.second);
+    }
+    if (changes.fields & SurfaceObserverChanges::Name) {
+        onNameChanged(changes.name);
+    }
+    if (changes.fields & SurfaceObserverChanges::Cursor) {
+        setCursor(changes.cursor);
+    }
+    if (changes.fields & SurfaceObserverChanges::Hidden) {
+        updateVisible();
+    }
+    if (changes.fields & SurfaceObserverChanges::MinimumWidth) {
+        onMinimumWidthChanged(changes.minimumWidth);
+    }
+    if (changes.fields & SurfaceObserverChanges::MinimumHeight) {
+        onMinimumHeightChanged(changes.minimumHeight);
+    }
+    if (changes.fields & SurfaceObserverChanges::MaximumWidth) {
+        onMaximumWidthChanged(changes.maximumWidth);
+    }
+    if (changes.fields & SurfaceObserverChanges::MaximumHeight) {
+        onMaximumHeightChanged(changes.maximumHeight);
+    }
+    if (changes.fields & SurfaceObserverChanges::WidthIncrement) {
+        onWidthIncrementChanged(changes.widthIncrement);
+    }
+    if (changes.fields & SurfaceObserverChanges::HeightIncrement) {
+        onHeightIncrementChanged(changes.heightIncrement);
+    }
+    if (changes.fields & SurfaceObserverChanges::ShellChrome) {
+        setShellChrome(toQtShellChrome(changes.shellChrome));
+    }
+    if (changes.fields & SurfaceObserverChanges::InputBounds) {
+        setInputBounds(changes.inputBounds);
+    }
+    if (changes.fields & SurfaceObserverChanges::ConfinesMousePointer) {
+        Q_EMIT confinesMousePointerChanged(changes.confinesMousePointer);
+    }
+}
+
 void MirSurface::onAttributeChanged(const MirWindowAttrib attribute, const int /*value*/)
 {
     switch (attribute) {
@@ -487,7 +538,11 @@ void MirSurface::setFocused(bool value)
             thinks are still pressed.
         */
         releaseAllPressedKeys();
+
+        applyKeymap();
     }
+
+    updateDirectInput();
 }
 
 void MirSurface::setViewActiveFocus(qintptr viewId, bool value)
@@ -695,6 +750,7 @@ bool MirSurface::visible() const
 void MirSurface::mousePressEvent(QMouseEvent *event)
 {
     auto ev = EventBuilder::instance()->reconstructMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -703,6 +759,7 @@ void MirSurface::mousePressEvent(QMouseEvent *event)
 void MirSurface::mouseMoveEvent(QMouseEvent *event)
 {
     auto ev = EventBuilder::instance()->reconstructMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -711,6 +768,7 @@ void MirSurface::mouseMoveEvent(QMouseEvent *event)
 void MirSurface::mouseReleaseEvent(QMouseEvent *event)
 {
     auto ev = EventBuilder::instance()->reconstructMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -719,6 +777,7 @@ void MirSurface::mouseReleaseEvent(QMouseEvent *event)
 void MirSurface::hoverEnterEvent(QHoverEvent *event)
 {
     auto ev = EventBuilder::instance()->reconstructMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -727,6 +786,7 @@ void MirSurface::hoverEnterEvent(QHoverEvent *event)
 void MirSurface::hoverLeaveEvent(QHoverEvent *event)
 {
     auto ev = EventBuilder::instance()->reconstructMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -735,6 +795,7 @@ void MirSurface::hoverLeaveEvent(QHoverEvent *event)
 void MirSurface::hoverMoveEvent(QHoverEvent *event)
 {
     auto ev = EventBuilder::instance()->reconstructMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -743,6 +804,7 @@ void MirSurface::hoverMoveEvent(QHoverEvent *event)
 void MirSurface::wheelEvent(QWheelEvent *event)
 {
     auto ev = EventBuilder::instance()->makeMirEvent(event);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirPointerEvent const*>(ev.get());
     m_controller->deliverPointerEvent(m_window, ev1);
     event->accept();
@@ -757,12 +819,15 @@ void MirSurface::keyPressEvent(QKeyEvent *qtEvent)
             auto info = EventBuilder::instance()->findInfo(qtEvent->timestamp());
             if (info) {
                 pressedKey.deviceId = info->deviceId;
+                pressedKey.mirTimestamp = info->mirTimestamp;
             }
             m_pressedKeys.append(std::move(pressedKey));
         }
     }
 
     auto ev = EventBuilder::instance()->makeMirEvent(qtEvent);
+
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirKeyboardEvent const*>(ev.get());
     m_controller->deliverKeyboardEvent(m_window, ev1);
     qtEvent->accept();
@@ -773,6 +838,7 @@ void MirSurface::keyReleaseEvent(QKeyEvent *qtEvent)
     if (isKeyPressed(qtEvent->nativeVirtualKey())) {
         forgetPressedKey(qtEvent->nativeVirtualKey());
         auto ev = EventBuilder::instance()->makeMirEvent(qtEvent);
+        traceSurfaceConsume(ev);
         auto ev1 = reinterpret_cast<MirKeyboardEvent const*>(ev.get());
         m_controller->deliverKeyboardEvent(m_window, ev1);
     } else {
@@ -786,6 +852,7 @@ void MirSurface::touchEvent(Qt::KeyboardModifiers mods,
                             ulong timestamp)
 {
     auto ev = EventBuilder::instance()->makeMirEvent(mods, touchPoints, touchPointStates, timestamp);
+    traceSurfaceConsume(ev);
     auto ev1 = reinterpret_cast<MirTouchEvent const*>(ev.get());
     m_controller->deliverTouchEvent(m_window, ev1);
 }
@@ -811,6 +878,7 @@ void MirSurface::registerView(qintptr viewId)
     if (m_views.count() == 1) {
         Q_EMIT isBeingDisplayedChanged();
     }
+    updateDirectInput();
 }
 
 void MirSurface::unregisterView(qintptr viewId)
@@ -822,6 +890,7 @@ void MirSurface::unregisterView(qintptr viewId)
     }
     updateExposure();
     setViewActiveFocus(viewId, false);
+    updateDirectInput();
 }
 
 void MirSurface::setViewExposure(qintptr viewId, bool exposed)
@@ -904,9 +973,18 @@ QString MirSurface::keymap() const
 
 void MirSurface::applyKeymap()
 {
+    /*
+        Mir compiles a new xkb keymap on every set_keymap() call. When the shell switches layout
+        it sets the keymap on every surface, so only the focused one, the only one getting key
+        events, has it applied right away. The others catch up once they get focus.
+    */
+    if (!m_focused || m_keymap == m_appliedKeymap) {
+        return;
+    }
+
     QStringList stringList = m_keymap.split('+', QString::SkipEmptyParts);
 
-    QString layout = stringList[0];
+    QString layout = stringList.value(0);
     QString variant;
 
     if (stringList.count() > 1) {
@@ -921,6 +999,7 @@ void MirSurface::applyKeymap()
     try
     {
         m_surface->set_keymap(MirInputDeviceId(), "", layout.toStdString(), variant.toStdString(), "");
+        m_appliedKeymap = m_keymap;
     }
     catch(std::exception const& e)
     {
@@ -977,6 +1056,25 @@ void MirSurface::updateState(Mir::State newState)
 
     // Mir determines visibility from the state, it may have changed
     updateVisible();
+
+    updateDirectInput();
+}
+
+/*
+    Input can skip the Qt scene when this surface is the focused fullscreen window and is shown by
+    a single view, as then there's nothing else in the scene the input could be meant for.
+    The shell still gets to veto it and to keep its edge gestures (see WindowControllerInterface).
+ */
+void MirSurface::updateDirectInput()
+{
+    const bool directInput = m_focused && m_state == Mir::FullscreenState && m_views.count() == 1;
+    if (directInput == m_directInput) {
+        return;
+    }
+
+    INFO_MSG << "(" << directInput << ")";
+    m_directInput = directInput;
+    m_controller->setDirectInputWindow(m_window, directInput);
 }
 
 void MirSurface::setReady()
@@ -1295,12 +1393,12 @@ void MirSurface::SurfaceObserverImpl::frame_posted(mir::scene::Surface const*, i
 
 void MirSurface::SurfaceObserverImpl::renamed(mir::scene::Surface const*, char const * name)
 {
-    Q_EMIT nameChanged(QString::fromUtf8(name));
+    recordName(name);
 }
 
 void MirSurface::SurfaceObserverImpl::cursor_image_removed(mir::scene::Surface const*)
 {
-    Q_EMIT cursorChanged(QCursor());
+    recordCursor(QCursor());
 }
 
 #if MIR_SERVER_VERSION >= MIR_VERSION_NUMBER(0, 25, 0)
@@ -1311,9 +1409,7 @@ void MirSurface::SurfaceObserverImpl::placed_relative(mir::scene::Surface const*
 
 void MirSurface::SurfaceObserverImpl::attrib_changed(mir::scene::Surface const*, MirWindowAttrib attribute, int value)
 {
-    if (m_listener) {
-        Q_EMIT attributeChanged(attribute, value);
-    }
+    recordAttribute(attribute, value);
 }
 
 #if MIR_SERVER_VERSION >= MIR_VERSION_NUMBER(1, 6, 0)
@@ -1327,13 +1423,12 @@ void MirSurface::SurfaceObserverImpl::resized_to(mir::scene::Surface const*, mir
 
 void MirSurface::SurfaceObserverImpl::hidden_set_to(mir::scene::Surface const*, bool hide)
 {
-    Q_EMIT hiddenChanged(hide);
+    recordHidden(hide);
 }
 
 void MirSurface::SurfaceObserverImpl::cursor_image_set_to(mir::scene::Surface const*, const mir::graphics::CursorImage &cursorImage)
 {
-    QCursor qcursor = createQCursorFromMirCursorImage(cursorImage);
-    Q_EMIT cursorChanged(qcursor);
+    recordCursor(createQCursorFromMirCursorImage(cursorImage));
 }
 
 #if MIR_SERVER_VERSION >= MIR_VERSION_NUMBER(0, 27, 0)
@@ -1356,12 +1451,12 @@ void MirSurface::SurfaceObserverImpl::frame_posted(int /*frames_available*/, mir
 
 void MirSurface::SurfaceObserverImpl::renamed(char const * name)
 {
-    Q_EMIT nameChanged(QString::fromUtf8(name));
+    recordName(name);
 }
 
 void MirSurface::SurfaceObserverImpl::cursor_image_removed()
 {
-    Q_EMIT cursorChanged(QCursor());
+    recordCursor(QCursor());
 }
 
 void MirSurface::SurfaceObserverImpl::placed_relative(mir::geometry::Rectangle const& /*placement*/)
@@ -1370,9 +1465,7 @@ void MirSurface::SurfaceObserverImpl::placed_relative(mir::geometry::Rectangle c
 
 void MirSurface::SurfaceObserverImpl::attrib_changed(MirWindowAttrib attribute, int value)
 {
-    if (m_listener) {
-        Q_EMIT attributeChanged(attribute, value);
-    }
+    recordAttribute(attribute, value);
 }
 
 void MirSurface::SurfaceObserverImpl::resized_to(mir::geometry::Size const&size)
@@ -1382,13 +1475,12 @@ void MirSurface::SurfaceObserverImpl::resized_to(mir::geometry::Size const&size)
 
 void MirSurface::SurfaceObserverImpl::hidden_set_to(bool hide)
 {
-    Q_EMIT hiddenChanged(hide);
+    recordHidden(hide);
 }
 
 void MirSurface::SurfaceObserverImpl::cursor_image_set_to(const mir::graphics::CursorImage &cursorImage)
 {
-    QCursor qcursor = createQCursorFromMirCursorImage(cursorImage);
-    Q_EMIT cursorChanged(qcursor);
+    recordCursor(createQCursorFromMirCursorImage(cursorImage));
 }
 
 #if MIR_SERVER_VERSION >= MIR_VERSION_NUMBER(0, 27, 0)
@@ -1402,6 +1494,41 @@ void MirSurface::SurfaceObserverImpl::start_drag_and_drop(std::vector<uint8_t> c
 #endif
 #endif
 
+void MirSurface::SurfaceObserverImpl::recordName(const char *name)
+{
+    const QString qname = QString::fromUtf8(name);
+    recordChange([&qname](SurfaceObserverChanges &changes) {
+        changes.name = qname;
+        changes.fields |= SurfaceObserverChanges::Name;
+    });
+}
+
+void MirSurface::SurfaceObserverImpl::recordCursor(const QCursor &cursor)
+{
+    recordChange([&cursor](SurfaceObserverChanges &changes) {
+        changes.cursor = cursor;
+        changes.fields |= SurfaceObserverChanges::Cursor;
+    });
+}
+
+void MirSurface::SurfaceObserverImpl::recordAttribute(MirWindowAttrib attribute, int value)
+{
+    if (!m_listener) {
+        return;
+    }
+    recordChange([attribute, value](SurfaceObserverChanges &changes) {
+        changes.setAttribute(attribute, value);
+    });
+}
+
+void MirSurface::SurfaceObserverImpl::recordHidden(bool hide)
+{
+    recordChange([hide](SurfaceObserverChanges &changes) {
+        changes.hidden = hide;
+        changes.fields |= SurfaceObserverChanges::Hidden;
+    });
+}
+
 QCursor MirSurface::SurfaceObserverImpl::createQCursorFromMirCursorImage(const mir::graphics::CursorImage &cursorImage) {
     if (cursorImage.as_argb_8888() == nullptr) {
         // Must be a named cursor
@@ -1506,11 +1633,15 @@ void MirSurface::releaseAllPressedKeys()
 {
     for (auto &pressedKey : m_pressedKeys) {
         auto deltaMs = (ulong)(msecsSinceReference() - pressedKey.msecsSinceReference);
-        ulong timestamp = pressedKey.timestamp + deltaMs;
+        std::chrono::nanoseconds timestamp;
+        if (pressedKey.mirTimestamp.count() != 0) {
+            timestamp = pressedKey.mirTimestamp + std::chrono::milliseconds(deltaMs);
+        } else {
+            timestamp = uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(pressedKey.timestamp + deltaMs));
+        }
         std::vector<uint8_t> cookie{};
 
-        auto ev = mir::events::make_event(pressedKey.deviceId,
-                uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(timestamp)),
+        auto ev = mir::events::make_event(pressedKey.deviceId, timestamp,
                 cookie, mir_keyboard_action_up, pressedKey.nativeVirtualKey, pressedKey.nativeScanCode,
                 mir_input_event_modifier_none);
 
@@ -39,6 +39,9 @@
 // mir
 #include <mir_toolkit/common.h>
 
+// std
+#include <chrono>
+
 
 class SurfaceObserver;
 
@@ -194,6 +197,7 @@ private Q_SLOTS:
     void dropPendingBuffer();
     void onAttributeChanged(const MirWindowAttrib, const int);
     void onFramesPostedObserved();
+    void onSurfaceChangesPending();
     void emitSizeChanged();
     void setCursor(const QCursor &cursor);
     void onCloseTimedOut();
@@ -206,6 +210,7 @@ private:
     void applyKeymap();
     void updateActiveFocus();
     void updateVisible();
+    void updateDirectInput();
     void onNameChanged(const QString &name);
     void onMinimumWidthChanged(int minWidth);
     void onMinimumHeightChanged(int minHeight);
@@ -269,6 +274,7 @@ private:
     bool m_sizePendingChange;
     QSize m_pendingResize;
     QString m_keymap;
+    QString m_appliedKeymap; // last keymap handed to Mir, which compiles it anew each time
 
     QCursor m_cursor;
     Mir::State m_state; // FIXME: remove when Mir gains additional window states to match Mir::State
@@ -278,6 +284,9 @@ private:
 
     bool m_focused{false};
 
+    // Whether input for this surface is currently delivered straight from Mir, bypassing the Qt scene
+    bool m_directInput{false};
+
     enum ClosingState {
         NotClosing = 0,
         Closing = 1,
@@ -298,6 +307,7 @@ private:
         quint32 nativeVirtualKey{0};
         quint32 nativeScanCode{0};
         ulong timestamp{0};
+        std::chrono::nanoseconds mirTimestamp{0};
         MirInputDeviceId deviceId{0};
         qint64 msecsSinceReference{0};
     };
@@ -121,6 +121,11 @@ Q_SIGNALS:
     void framesPosted();
     void isBeingDisplayedChanged();
     void frameDropped();
+
+    // Client-requested move or resize, carried out by the window manager; position and size
+    // updates in between come from it too
+    void moveResizeStarted();
+    void moveResizeEnded();
 };
 
 } // namespace qtmir
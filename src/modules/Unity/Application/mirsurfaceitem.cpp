@@ -20,11 +20,13 @@
 #include "mirsurfaceitem.h"
 #include "logging.h"
 #include "tracepoints.h" // generated from tracepoints.tp
-#include "timestamp.h"
 
 // common
 #include <debughelpers.h>
 
+// mirserver
+#include <eventbuilder.h>
+
 // Qt
 #include <QDebug>
 #include <QGuiApplication>
@@ -57,6 +59,25 @@ public:
     QObject *textureProvider;
 };
 
+// Traces the time spent by MirSurfaceItem consuming an input event
+class InputEventConsumeTrace
+{
+public:
+    InputEventConsumeTrace(MirInputEventType type, ulong qtTimestamp)
+        : m_type(type), m_qtTimestamp(qtTimestamp)
+    {
+        tracepoint(qtmir, inputEventConsume_start, m_type, mirEventTime());
+    }
+    ~InputEventConsumeTrace()
+    {
+        tracepoint(qtmir, inputEventConsume_end, m_type, mirEventTime());
+    }
+private:
+    int64_t mirEventTime() const { return EventBuilder::instance()->mirEventTime(m_qtTimestamp).count(); }
+    const MirInputEventType m_type;
+    const ulong m_qtTimestamp;
+};
+
 } // namespace {
 
 class MirTextureProvider : public QSGTextureProvider
@@ -289,6 +310,8 @@ QSGNode *MirSurfaceItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
 
 void MirSurfaceItem::mousePressEvent(QMouseEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     auto mousePos = event->localPos().toPoint();
     if (m_consumesInput && m_surface && m_surface->live() && m_surface->inputAreaContains(mousePos)) {
         m_surface->mousePressEvent(event);
@@ -299,6 +322,8 @@ void MirSurfaceItem::mousePressEvent(QMouseEvent *event)
 
 void MirSurfaceItem::mouseMoveEvent(QMouseEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->mouseMoveEvent(event);
     } else {
@@ -308,6 +333,8 @@ void MirSurfaceItem::mouseMoveEvent(QMouseEvent *event)
 
 void MirSurfaceItem::mouseReleaseEvent(QMouseEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->mouseReleaseEvent(event);
     } else {
@@ -317,6 +344,8 @@ void MirSurfaceItem::mouseReleaseEvent(QMouseEvent *event)
 
 void MirSurfaceItem::wheelEvent(QWheelEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->wheelEvent(event);
     } else {
@@ -326,6 +355,8 @@ void MirSurfaceItem::wheelEvent(QWheelEvent *event)
 
 void MirSurfaceItem::hoverEnterEvent(QHoverEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->hoverEnterEvent(event);
     } else {
@@ -335,6 +366,8 @@ void MirSurfaceItem::hoverEnterEvent(QHoverEvent *event)
 
 void MirSurfaceItem::hoverLeaveEvent(QHoverEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->hoverLeaveEvent(event);
     } else {
@@ -344,6 +377,8 @@ void MirSurfaceItem::hoverLeaveEvent(QHoverEvent *event)
 
 void MirSurfaceItem::hoverMoveEvent(QHoverEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_pointer, event->timestamp());
+
     // WORKAROUND for https://github.com/ubports/ubuntu-touch/issues/787
     // This is a improved workaround that allows "mouse" hover events to work correctly by
     // ignoring hover move events with no timestamp as these are bogus synthesized touch events
@@ -356,6 +391,8 @@ void MirSurfaceItem::hoverMoveEvent(QHoverEvent *event)
 
 void MirSurfaceItem::keyPressEvent(QKeyEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_key, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->keyPressEvent(event);
     } else {
@@ -365,6 +402,8 @@ void MirSurfaceItem::keyPressEvent(QKeyEvent *event)
 
 void MirSurfaceItem::keyReleaseEvent(QKeyEvent *event)
 {
+    InputEventConsumeTrace trace(mir_input_event_type_key, event->timestamp());
+
     if (m_consumesInput && m_surface && m_surface->live()) {
         m_surface->keyReleaseEvent(event);
     } else {
@@ -437,13 +476,11 @@ void MirSurfaceItem::validateAndDeliverTouchEvent(int eventType,
     m_lastTouchEvent->timestamp = timestamp;
     m_lastTouchEvent->touchPoints = touchPoints;
     m_lastTouchEvent->touchPointStates = touchPointStates;
-
-    tracepoint(qtmir, touchEventConsume_end, uncompressTimestamp<ulong>(timestamp).count());
 }
 
 void MirSurfaceItem::touchEvent(QTouchEvent *event)
 {
-    tracepoint(qtmir, touchEventConsume_start, uncompressTimestamp<ulong>(event->timestamp()).count());
+    InputEventConsumeTrace trace(mir_input_event_type_touch, event->timestamp());
 
     bool accepted = processTouchEvent(event->type(),
             event->timestamp(),
@@ -18,24 +18,112 @@
 
 // Qt
 #include <QFile>
-#include <QRegularExpression>
+#include <QMutexLocker>
 
 namespace qtmir
 {
 
+namespace {
+
+// Past this many processes, forget those that went away
+const int maxEntries = 64;
+
+QByteArray readProcFile(pid_t pid, const char *name)
+{
+    QFile file(QStringLiteral("/proc/%1/%2").arg(pid).arg(QLatin1String(name)));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+// Start time of the process, in clock ticks since boot, telling it apart from earlier processes with the same pid
+quint64 startTimeOf(pid_t pid)
+{
+    const QByteArray stat = readProcFile(pid, "stat");
+
+    // The command name in parentheses may contain spaces, so count fields from after it
+    const int commandEnd = stat.lastIndexOf(')');
+    if (commandEnd < 0) {
+        return 0;
+    }
+    const QList<QByteArray> fields = stat.mid(commandEnd + 2).split(' ');
+    const int startTimeField = 19; // field 22 of proc(5), counting from the state field
+    return fields.count() > startTimeField ? fields[startTimeField].toULongLong() : 0;
+}
+
+QList<QByteArray> splitOnNul(const QByteArray &data)
+{
+    QList<QByteArray> parts = data.split('\0');
+    // The data ends with a NUL, which leaves an empty part behind
+    if (!parts.isEmpty() && parts.last().isEmpty()) {
+        parts.removeLast();
+    }
+    return parts;
+}
+
+} // anonymous namespace
+
+ProcInfo::Entry &ProcInfo::entryFor(pid_t pid, quint64 startTime)
+{
+    auto it = m_entries.find(pid);
+    if (it != m_entries.end() && it->startTime == startTime) {
+        return it.value();
+    }
+
+    if (it == m_entries.end() && m_entries.count() >= maxEntries) {
+        for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+            if (startTimeOf(entry.key()) != entry->startTime) {
+                entry = m_entries.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+    }
+
+    Entry &entry = m_entries[pid];
+    entry = Entry();
+    entry.startTime = startTime;
+    return entry;
+}
+
 std::unique_ptr<ProcInfo::CommandLine> ProcInfo::commandLine(pid_t pid)
 {
-    QFile cmdline(QStringLiteral("/proc/%1/cmdline").arg(pid));
-    if (!cmdline.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    const quint64 startTime = startTimeOf(pid);
+    if (startTime == 0) {
         return nullptr;
     }
 
-    return std::unique_ptr<CommandLine>(new CommandLine{ cmdline.readLine().replace('\0', ' ') });
+    QMutexLocker locker(&m_mutex);
+    Entry &entry = entryFor(pid, startTime);
+    if (!entry.commandLine) {
+        const QByteArray cmdline = readProcFile(pid, "cmdline");
+        if (cmdline.isEmpty()) {
+            return nullptr;
+        }
+        entry.commandLine = std::make_shared<const CommandLine>(cmdline);
+    }
+
+    return std::unique_ptr<CommandLine>(new CommandLine(*entry.commandLine));
+}
+
+ProcInfo::CommandLine::CommandLine(const QByteArray &arguments)
+{
+    for (const QByteArray &argument : splitOnNul(arguments)) {
+        const QString qargument = QString::fromLocal8Bit(argument);
+        m_arguments << qargument;
+
+        const int equals = qargument.indexOf(QLatin1Char('='));
+        if (equals > 0 && equals < qargument.size() - 1 && !m_parameters.contains(qargument.left(equals + 1))) {
+            m_parameters.insert(qargument.left(equals + 1), qargument.mid(equals + 1));
+        }
+    }
+    m_command = m_arguments.join(QLatin1Char(' ')).toLocal8Bit();
 }
 
 QStringList ProcInfo::CommandLine::asStringList() const
 {
-    return QString(m_command.data()).split(' ');
+    return m_arguments;
 }
 
 bool ProcInfo::CommandLine::startsWith(char const* prefix) const
@@ -50,49 +138,61 @@ bool ProcInfo::CommandLine::contains(char const* prefix) const
 
 QString ProcInfo::CommandLine::getParameter(const char* name) const
 {
-    QString pattern = QRegularExpression::escape(name) + "(\\S+)";
-    QRegularExpression regExp(pattern);
-    QRegularExpressionMatch regExpMatch = regExp.match(m_command);
-
-    if (!regExpMatch.hasMatch()) {
-        return QString();
+    const QString qname = QString::fromLatin1(name);
+    if (qname.endsWith(QLatin1Char('='))) {
+        return m_parameters.value(qname);
     }
 
-    return QString(regExpMatch.captured(1));
+    for (const QString &argument : m_arguments) {
+        if (argument.startsWith(qname) && argument.size() > qname.size()) {
+            return argument.mid(qname.size());
+        }
+    }
+    return QString();
 }
 
 QString ProcInfo::CommandLine::getExec() const
 {
-    return asStringList()[0];
+    return m_arguments.value(0);
 }
 
 
 std::unique_ptr<ProcInfo::Environment> ProcInfo::environment(pid_t pid)
 {
-    QFile environment(QStringLiteral("/proc/%1/environ").arg(pid));
-    if (!environment.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    const quint64 startTime = startTimeOf(pid);
+    if (startTime == 0) {
         return nullptr;
     }
 
-    return std::unique_ptr<Environment>(new Environment{ environment.readLine().replace('\0', ' ') });
+    QMutexLocker locker(&m_mutex);
+    Entry &entry = entryFor(pid, startTime);
+    if (!entry.environment) {
+        // An unreadable environment is as good as an empty one, and will stay that way
+        entry.environment = std::make_shared<const Environment>(readProcFile(pid, "environ"));
+    }
+
+    return std::unique_ptr<Environment>(new Environment(*entry.environment));
+}
+
+ProcInfo::Environment::Environment(const QByteArray &variables)
+{
+    for (const QByteArray &variable : splitOnNul(variables)) {
+        const int equals = variable.indexOf('=');
+        if (equals > 0) {
+            m_variables.insert(QString::fromLocal8Bit(variable.left(equals)),
+                               QString::fromLocal8Bit(variable.mid(equals + 1)));
+        }
+    }
 }
 
 bool ProcInfo::Environment::contains(char const* prefix) const
 {
-    return m_environment.contains(prefix);
+    return m_variables.contains(QString::fromLatin1(prefix));
 }
 
 QString ProcInfo::Environment::getParameter(const char* name) const
 {
-    QString pattern = QRegularExpression::escape(name) + "=(\\S+)";
-    QRegularExpression regExp(pattern);
-    QRegularExpressionMatch regExpMatch = regExp.match(m_environment);
-
-    if (!regExpMatch.hasMatch()) {
-        return QString();
-    }
-
-    return QString(regExpMatch.captured(1));
+    return m_variables.value(QString::fromLatin1(name));
 }
 
 } // namespace qtmir
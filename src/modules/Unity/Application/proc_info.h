@@ -24,8 +24,12 @@
 
 // Qt
 #include <QByteArray>
+#include <QHash>
+#include <QMutex>
 #include <QStringList>
 
+#include <sys/types.h>
+
 class QString;
 
 namespace qtmir
@@ -35,25 +39,49 @@ class ProcInfo
 {
 public:
     struct CommandLine {
-        QByteArray m_command;
+        // From the NUL separated arguments, as found in /proc/<pid>/cmdline
+        explicit CommandLine(const QByteArray &arguments);
+
+        QByteArray m_command; // arguments separated by spaces
 
         bool startsWith(const char* prefix) const;
         bool contains(const char* prefix) const;
         QString getParameter(const char* name) const;
         QStringList asStringList() const;
         QString getExec() const;
+
+    private:
+        QStringList m_arguments;
+        QHash<QString, QString> m_parameters; // "--name=" -> value
     };
 
     struct Environment {
-        QByteArray m_environment;
+        // From the NUL separated NAME=value pairs, as found in /proc/<pid>/environ
+        explicit Environment(const QByteArray &variables);
 
         bool contains(const char* prefix) const;
         QString getParameter(const char* name) const;
+
+    private:
+        QHash<QString, QString> m_variables;
     };
 
     virtual std::unique_ptr<CommandLine> commandLine(pid_t pid);
     virtual std::unique_ptr<Environment> environment(pid_t pid);
     virtual ~ProcInfo() = default;
+
+private:
+    // What was read of a process, valid for as long as a process with that pid and start time exists
+    struct Entry {
+        quint64 startTime{0};
+        std::shared_ptr<const CommandLine> commandLine;
+        std::shared_ptr<const Environment> environment;
+    };
+
+    Entry &entryFor(pid_t pid, quint64 startTime);
+
+    QMutex m_mutex;
+    QHash<pid_t, Entry> m_entries;
 };
 
 } // namespace qtmir
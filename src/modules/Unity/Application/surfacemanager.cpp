@@ -38,6 +38,15 @@ Q_LOGGING_CATEGORY(QTMIR_SURFACEMANAGER, "qtmir.surfacemanager", QtInfoMsg)
 using namespace qtmir;
 namespace unityapi = unity::shell::application;
 
+namespace {
+
+const mir::scene::Surface *sceneSurfaceOf(const miral::Window &window)
+{
+    return std::shared_ptr<mir::scene::Surface>(window).get();
+}
+
+} // anonymous namespace
+
 
 SurfaceManager::SurfaceManager()
 {
@@ -68,31 +77,34 @@ SurfaceManager::SurfaceManager(WindowControllerInterface *windowController,
 
 void SurfaceManager::connectToWindowModelNotifier(WindowModelNotifier *notifier)
 {
-    connect(notifier, &WindowModelNotifier::windowAdded,          this, &SurfaceManager::onWindowAdded,           Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowRemoved,        this, &SurfaceManager::onWindowRemoved,         Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowReady,          this, &SurfaceManager::onWindowReady,           Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowMoved,          this, &SurfaceManager::onWindowMoved,           Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowStateChanged,   this, &SurfaceManager::onWindowStateChanged,    Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowFocusChanged,   this, &SurfaceManager::onWindowFocusChanged,    Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowsRaised,        this, &SurfaceManager::onWindowsRaised,         Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::windowRequestedRaise, this, &SurfaceManager::onWindowsRequestedRaise, Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::modificationsStarted, this, &SurfaceManager::modificationsStarted,    Qt::QueuedConnection);
-    connect(notifier, &WindowModelNotifier::modificationsEnded,   this, &SurfaceManager::modificationsEnded,      Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowAdded,             this, &SurfaceManager::onWindowAdded,             Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowRemoved,           this, &SurfaceManager::onWindowRemoved,           Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowReady,             this, &SurfaceManager::onWindowReady,             Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowMoved,             this, &SurfaceManager::onWindowMoved,             Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowStateChanged,      this, &SurfaceManager::onWindowStateChanged,      Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowFocusChanged,      this, &SurfaceManager::onWindowFocusChanged,      Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowsRaised,           this, &SurfaceManager::onWindowsRaised,           Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowRequestedRaise,    this, &SurfaceManager::onWindowsRequestedRaise,   Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowMoveResizeStarted, this, &SurfaceManager::onWindowMoveResizeStarted, Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::windowMoveResizeEnded,   this, &SurfaceManager::onWindowMoveResizeEnded,   Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::changesCommitted,        this, &SurfaceManager::onChangesCommitted,        Qt::QueuedConnection);
 }
 
 void SurfaceManager::rememberMirSurface(MirSurface *surface)
 {
     m_allSurfaces.append(surface);
+    m_surfacesBySceneSurface.insert(sceneSurfaceOf(surface->window()), surface);
 }
 
 void SurfaceManager::forgetMirSurface(const miral::Window &window)
 {
-    for (int i = 0; i < m_allSurfaces.count(); ++i) {
-        if (m_allSurfaces[i]->window() == window) {
-            m_allSurfaces.removeAt(i);
-            return;
-        }
+    auto surface = find(window);
+    if (!surface) {
+        return;
     }
+
+    m_surfacesBySceneSurface.remove(sceneSurfaceOf(window), surface);
+    m_allSurfaces.removeOne(surface);
 }
 
 void SurfaceManager::onWindowAdded(const NewWindow &window)
@@ -153,9 +165,11 @@ MirSurface *SurfaceManager::find(const miral::WindowInfo &needle) const
 
 MirSurface *SurfaceManager::find(const miral::Window &window) const
 {
-    Q_FOREACH(const auto surface, m_allSurfaces) {
-        if (surface->window() == window) {
-            return surface;
+    const auto sceneSurface = sceneSurfaceOf(window);
+    for (auto it = m_surfacesBySceneSurface.constFind(sceneSurface);
+            it != m_surfacesBySceneSurface.constEnd() && it.key() == sceneSurface; ++it) {
+        if (it.value()->window() == window) {
+            return it.value();
         }
     }
     return nullptr;
@@ -192,8 +206,6 @@ void SurfaceManager::onWindowStateChanged(const miral::WindowInfo &windowInfo, M
 
 void SurfaceManager::onWindowsRaised(const std::vector<miral::Window> &windows)
 {
-    // sad inefficiency when crossing API boundaries (from miral to qt)
-
     const int raiseCount = windows.size();
 
     DEBUG_MSG << "() raiseCount = " << raiseCount;
@@ -217,6 +229,65 @@ void SurfaceManager::onWindowsRequestedRaise(const miral::WindowInfo &windowInfo
     }
 }
 
+void SurfaceManager::onWindowMoveResizeStarted(const miral::WindowInfo &windowInfo)
+{
+    if (auto mirSurface = find(windowInfo)) {
+        Q_EMIT mirSurface->moveResizeStarted();
+    }
+}
+
+void SurfaceManager::onWindowMoveResizeEnded(const miral::WindowInfo &windowInfo)
+{
+    if (auto mirSurface = find(windowInfo)) {
+        Q_EMIT mirSurface->moveResizeEnded();
+    }
+}
+
+void SurfaceManager::onChangesCommitted(const WindowModelChanges &changes)
+{
+    Q_EMIT modificationsStarted();
+
+    changes->seal();
+    for (const auto &change : changes->changes()) {
+        switch (change.type) {
+        case WindowModelChangeSet::WindowAdded:
+            onWindowAdded(change.newWindow());
+            break;
+        case WindowModelChangeSet::WindowRemoved:
+            onWindowRemoved(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowReady:
+            onWindowReady(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowMoved:
+            onWindowMoved(change.windowInfo, change.topLeft);
+            break;
+        case WindowModelChangeSet::WindowStateChanged:
+            onWindowStateChanged(change.windowInfo, change.state);
+            break;
+        case WindowModelChangeSet::WindowFocusChanged:
+            onWindowFocusChanged(change.windowInfo, change.focused);
+            break;
+        case WindowModelChangeSet::WindowsRaised:
+            onWindowsRaised(change.windows);
+            break;
+        case WindowModelChangeSet::WindowRequestedRaise:
+            onWindowsRequestedRaise(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowMoveResizeStarted:
+            onWindowMoveResizeStarted(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowMoveResizeEnded:
+            onWindowMoveResizeEnded(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowResized:
+            break;
+        }
+    }
+
+    Q_EMIT modificationsEnded();
+}
+
 void SurfaceManager::raise(unityapi::MirSurfaceInterface *surface)
 {
     DEBUG_MSG << "(" << surface << ")";
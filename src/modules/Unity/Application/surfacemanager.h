@@ -23,11 +23,14 @@
 // Unity API
 #include <unity/shell/application/SurfaceManagerInterface.h>
 
+#include <QMultiHash>
 #include <QVector>
 #include <QLoggingCategory>
 
 Q_DECLARE_LOGGING_CATEGORY(QTMIR_SURFACEMANAGER)
 
+namespace mir { namespace scene { class Surface; } }
+
 namespace qtmir {
 
 class MirSurface;
@@ -60,6 +63,9 @@ private Q_SLOTS:
     void onWindowFocusChanged(const miral::WindowInfo &windowInfo, bool focused);
     void onWindowsRaised(const std::vector<miral::Window> &windows);
     void onWindowsRequestedRaise(const miral::WindowInfo &windowInfo);
+    void onWindowMoveResizeStarted(const miral::WindowInfo &windowInfo);
+    void onWindowMoveResizeEnded(const miral::WindowInfo &windowInfo);
+    void onChangesCommitted(const qtmir::WindowModelChanges &changes);
 
 private:
     void connectToWindowModelNotifier(WindowModelNotifier *notifier);
@@ -69,6 +75,11 @@ private:
 
     QVector<MirSurface*> m_allSurfaces;
 
+    // Index over m_allSurfaces so that window notifications don't have to scan every surface.
+    // Keyed by the underlying mir::scene::Surface, which is what a miral::Window wraps;
+    // lookups still compare the miral::Window itself to pick the right entry.
+    QMultiHash<const mir::scene::Surface*, MirSurface*> m_surfacesBySceneSurface;
+
     WindowControllerInterface *m_windowController;
     SessionMapInterface *m_sessionMap;
 };
@@ -22,6 +22,10 @@
 #include <logging.h>
 
 // Qt
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
 #include <QStandardPaths>
 
 // upstart
@@ -39,6 +43,20 @@ namespace upstart
 
 struct TaskController::Private
 {
+    // UAL application handles are costly to create, so they are kept until the application stops
+    struct CachedApp {
+        std::shared_ptr<ual::Application> app;
+        QSet<pid_t> pids; // of its instances, as of when one last started or stopped
+    };
+
+    std::shared_ptr<ual::Application> app(const QString &appId);
+    bool appHasPid(const QString &appId, pid_t pid);
+    void refreshPids(const QString &appId);
+    void forgetApp(const QString &appId);
+
+    QMutex cacheMutex; // UAL observers, the Qt GUI thread and Mir threads all get here
+    QHash<QString, CachedApp> cache; // keyed by short appId
+
     std::shared_ptr<ual::Registry> registry;
     UbuntuAppLaunchAppObserver preStartCallback = nullptr;
     UbuntuAppLaunchAppObserver startedCallback = nullptr;
@@ -87,6 +105,99 @@ std::shared_ptr<ual::Application> createApp(const QString &inputAppId, std::shar
 
 } // namespace
 
+std::shared_ptr<ual::Application> TaskController::Private::app(const QString &appId)
+{
+    const QString shortAppId = toShortAppIdIfPossible(appId);
+    {
+        QMutexLocker locker(&cacheMutex);
+        auto it = cache.constFind(shortAppId);
+        if (it != cache.constEnd()) {
+            return it->app;
+        }
+    }
+
+    auto app = createApp(appId, registry);
+    if (app) {
+        QMutexLocker locker(&cacheMutex);
+        auto &cached = cache[shortAppId];
+        if (!cached.app) {
+            cached.app = app;
+        }
+        return cached.app;
+    }
+    return app;
+}
+
+bool TaskController::Private::appHasPid(const QString &appId, pid_t pid)
+{
+    const QString shortAppId = toShortAppIdIfPossible(appId);
+    {
+        QMutexLocker locker(&cacheMutex);
+        auto it = cache.constFind(shortAppId);
+        if (it != cache.constEnd() && it->pids.contains(pid)) {
+            return true;
+        }
+    }
+
+    // Not one of its processes when it last started or stopped, but it may have started others since
+    auto handle = app(appId);
+    if (!handle) {
+        return false;
+    }
+
+    for (auto &instance: handle->instances()) {
+        if (instance->hasPid(pid)) {
+            QMutexLocker locker(&cacheMutex);
+            auto it = cache.find(shortAppId);
+            if (it != cache.end() && it->app == handle) {
+                it->pids.insert(pid);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Called from the UAL observers, so that appHasPid() seldom has to ask UAL itself. Only refreshes
+// applications already cached, the others get a handle when first asked about.
+void TaskController::Private::refreshPids(const QString &appId)
+{
+    std::shared_ptr<ual::Application> handle;
+    {
+        QMutexLocker locker(&cacheMutex);
+        auto it = cache.constFind(toShortAppIdIfPossible(appId));
+        if (it == cache.constEnd()) {
+            return;
+        }
+        handle = it->app;
+    }
+
+    QSet<pid_t> pids;
+    for (auto &instance: handle->instances()) {
+        for (pid_t instancePid: instance->pids()) {
+            pids.insert(instancePid);
+        }
+    }
+
+    QMutexLocker locker(&cacheMutex);
+    auto it = cache.find(toShortAppIdIfPossible(appId));
+    if (it == cache.end() || it->app != handle) {
+        return;
+    }
+    if (pids.isEmpty()) {
+        // Not running any more: a later launch resolves the app id again, picking up any new version
+        cache.erase(it);
+    } else {
+        it->pids = pids;
+    }
+}
+
+void TaskController::Private::forgetApp(const QString &appId)
+{
+    QMutexLocker locker(&cacheMutex);
+    cache.remove(toShortAppIdIfPossible(appId));
+}
+
 TaskController::TaskController()
     : qtmir::TaskController(),
       impl(new Private())
@@ -100,11 +211,13 @@ TaskController::TaskController()
 
     impl->startedCallback = [](const gchar * appId, gpointer userData) {
         auto thiz = static_cast<TaskController*>(userData);
+        thiz->impl->refreshPids(QString::fromUtf8(appId));
         Q_EMIT(thiz->applicationStarted(toShortAppIdIfPossible(appId)));
     };
 
     impl->stopCallback = [](const gchar * appId, gpointer userData) {
         auto thiz = static_cast<TaskController*>(userData);
+        thiz->impl->refreshPids(QString::fromUtf8(appId));
         Q_EMIT(thiz->processStopped(toShortAppIdIfPossible(appId)));
     };
 
@@ -132,6 +245,7 @@ TaskController::TaskController()
         }
 
         auto thiz = static_cast<TaskController*>(userData);
+        thiz->impl->forgetApp(QString::fromUtf8(appId));
         Q_EMIT(thiz->processFailed(toShortAppIdIfPossible(appId), error));
     };
 
@@ -157,23 +271,12 @@ TaskController::~TaskController()
 
 bool TaskController::appIdHasProcessId(const QString& appId, pid_t pid)
 {
-    auto app = createApp(appId, impl->registry);
-    if (!app) {
-        return false;
-    }
-
-    for (auto &instance: app->instances()) {
-        if (instance->hasPid(pid)) {
-            return true;
-        }
-    }
-
-    return false;
+    return impl->appHasPid(appId, pid);
 }
 
 bool TaskController::stop(const QString& appId)
 {
-    auto app = createApp(appId, impl->registry);
+    auto app = impl->app(appId);
     if (!app) {
         return false;
     }
@@ -187,7 +290,7 @@ bool TaskController::stop(const QString& appId)
 
 bool TaskController::start(const QString& appId, const QStringList& arguments)
 {
-    auto app = createApp(appId, impl->registry);
+    auto app = impl->app(appId);
     if (!app) {
         return false;
     }
@@ -205,7 +308,7 @@ bool TaskController::start(const QString& appId, const QStringList& arguments)
 
 bool TaskController::suspend(const QString& appId)
 {
-    auto app = createApp(appId, impl->registry);
+    auto app = impl->app(appId);
     if (!app) {
         return false;
     }
@@ -219,7 +322,7 @@ bool TaskController::suspend(const QString& appId)
 
 bool TaskController::resume(const QString& appId)
 {
-    auto app = createApp(appId, impl->registry);
+    auto app = impl->app(appId);
     if (!app) {
         return false;
     }
@@ -233,7 +336,7 @@ bool TaskController::resume(const QString& appId)
 
 QSharedPointer<qtmir::ApplicationInfo> TaskController::getInfoForApp(const QString &appId) const
 {
-    auto app = createApp(appId, impl->registry);
+    auto app = impl->app(appId);
     if (!app || !app->info()) {
         return QSharedPointer<qtmir::ApplicationInfo>();
     }
@@ -23,10 +23,20 @@
 
 // Qt
 #include <QGuiApplication>
+#include <QMultiHash>
 #include <QDebug>
 
 using namespace qtmir;
 
+namespace {
+
+const mir::scene::Surface *sceneSurfaceOf(const miral::Window &window)
+{
+    return std::shared_ptr<mir::scene::Surface>(window).get();
+}
+
+} // anonymous namespace
+
 WindowModel::WindowModel()
 {
     auto nativeInterface = dynamic_cast<NativeInterface*>(QGuiApplication::platformNativeInterface());
@@ -57,6 +67,7 @@ void WindowModel::connectToWindowModelNotifier(WindowModelNotifier *notifier)
     connect(notifier, &WindowModelNotifier::windowStateChanged, this, &WindowModel::onWindowStateChanged, Qt::QueuedConnection);
     connect(notifier, &WindowModelNotifier::windowFocusChanged, this, &WindowModel::onWindowFocusChanged, Qt::QueuedConnection);
     connect(notifier, &WindowModelNotifier::windowsRaised,      this, &WindowModel::onWindowsRaised,      Qt::QueuedConnection);
+    connect(notifier, &WindowModelNotifier::changesCommitted,   this, &WindowModel::onChangesCommitted,   Qt::QueuedConnection);
 }
 
 QHash<int, QByteArray> WindowModel::roleNames() const
@@ -77,7 +88,9 @@ void WindowModel::onWindowAdded(const NewWindow &window)
     beginInsertRows(QModelIndex(), index, index);
     m_windowModel.append(new MirSurface(window, m_windowController));
     endInsertRows();
-    Q_EMIT countChanged();
+    if (!m_applyingChanges) {
+        Q_EMIT countChanged();
+    }
 }
 
 void WindowModel::onWindowRemoved(const miral::WindowInfo &windowInfo)
@@ -92,7 +105,9 @@ void WindowModel::onWindowRemoved(const miral::WindowInfo &windowInfo)
     beginRemoveRows(QModelIndex(), index, index);
     m_windowModel.takeAt(index);
     endRemoveRows();
-    Q_EMIT countChanged();
+    if (!m_applyingChanges) {
+        Q_EMIT countChanged();
+    }
 }
 
 void WindowModel::onWindowReady(const miral::WindowInfo &windowInfo)
@@ -146,47 +161,130 @@ void WindowModel::onWindowsRaised(const std::vector<miral::Window> &windows)
 {
     // Reminder: last item in the "windows" list should end up at the top of the model
     const int modelCount = m_windowModel.count();
-    const int raiseCount = windows.size();
-
-    // Assumption: no NO-OPs are in this list - Qt will crash on endMoveRows() if you try NO-OPs!!!
-    // A NO-OP is if
-    //    1. "indices" is an empty list
-    //    2. "indices" of the form (..., modelCount - 2, modelCount - 1) which results in an unchanged list
-
-    // Precompute the list of indices of Windows/Surfaces to raise, including the offsets due to
-    // indices which have already been moved.
-    QVector<QPair<int /*from*/, int /*to*/>> moveList;
-
-    for (int i=raiseCount-1; i>=0; i--) {
-        int from = findIndexOf(windows[i]);
-        const int to = modelCount - raiseCount + i;
-
-        int moveCount = 0;
-        // how many list items under "index" have been moved so far, correct "from" to suit
-        for (int j=raiseCount-1; j>i; j--) {
-            if (findIndexOf(windows[j]) < from) {
-                moveCount++;
+
+    // Index the model by the mir::scene::Surface each window wraps. Several windows may share
+    // one (only in tests), so candidates are still compared by window.
+    QMultiHash<const mir::scene::Surface*, int> rowsBySceneSurface;
+    rowsBySceneSurface.reserve(modelCount);
+    for (int row = 0; row < modelCount; row++) {
+        rowsBySceneSurface.insert(sceneSurfaceOf(m_windowModel[row]->window()), row);
+    }
+
+    // Rows to raise, in their final bottom-to-top order
+    QVector<bool> isRaised(modelCount, false);
+    QVector<int> raisedRows;
+    raisedRows.reserve(windows.size());
+    for (const auto &window : windows) {
+        const auto sceneSurface = sceneSurfaceOf(window);
+        for (auto it = rowsBySceneSurface.constFind(sceneSurface);
+                it != rowsBySceneSurface.constEnd() && it.key() == sceneSurface; ++it) {
+            const int row = it.value();
+            if (m_windowModel[row]->window() == window) {
+                if (!isRaised[row]) {
+                    isRaised[row] = true;
+                    raisedRows.append(row);
+                }
+                break;
             }
         }
-        from -= moveCount;
+    }
+
+    if (raisedRows.isEmpty()) {
+        return;
+    }
 
-        if (from == to) {
-            // is NO-OP, would result in moving element to itself
-        } else {
-            moveList.prepend({from, to});
+    // Final order: everything not raised keeps its relative order, the raised rows go on top
+    QVector<int> newRowOf(modelCount);
+    QVector<MirSurface*> newOrder;
+    newOrder.reserve(modelCount);
+    for (int row = 0; row < modelCount; row++) {
+        if (!isRaised[row]) {
+            newRowOf[row] = newOrder.count();
+            newOrder.append(m_windowModel[row]);
         }
     }
+    for (const int row : raisedRows) {
+        newRowOf[row] = newOrder.count();
+        newOrder.append(m_windowModel[row]);
+    }
 
-    // Perform the moving, trusting the moveList is correct for each iteration.
-    QModelIndex parent;
-    for (int i=moveList.count()-1; i>=0; i--) {
-        const int from = moveList[i].first;
-        const int to = moveList[i].second;
+    int firstChanged = 0;
+    while (firstChanged < modelCount && newRowOf[firstChanged] == firstChanged) {
+        firstChanged++;
+    }
+    if (firstChanged == modelCount) {
+        return; // NO-OP, Qt will crash on endMoveRows() if asked to move rows onto themselves
+    }
 
-        beginMoveRows(parent, from, from, parent, to+1);
-        m_windowModel.move(from, to);
+    // The usual case is a single contiguous block of rows going to the top (one window, or a
+    // window together with its dialogs and menus). That is one move; anything else is a relayout.
+    const int blockEnd = m_windowModel.indexOf(newOrder.last(), firstChanged);
+    bool isSingleMove = blockEnd >= firstChanged;
+    for (int row = firstChanged; isSingleMove && row < modelCount; row++) {
+        const int expected = row <= blockEnd ? modelCount - (blockEnd - row + 1)
+                                             : row - (blockEnd - firstChanged + 1);
+        isSingleMove = newRowOf[row] == expected;
+    }
 
+    if (isSingleMove) {
+        QModelIndex parent;
+        beginMoveRows(parent, firstChanged, blockEnd, parent, modelCount);
+        m_windowModel = newOrder;
         endMoveRows();
+    } else {
+        Q_EMIT layoutAboutToBeChanged();
+        const QModelIndexList oldIndexes = persistentIndexList();
+        QModelIndexList newIndexes;
+        newIndexes.reserve(oldIndexes.count());
+        for (const auto &oldIndex : oldIndexes) {
+            newIndexes.append(index(newRowOf[oldIndex.row()]));
+        }
+        m_windowModel = newOrder;
+        changePersistentIndexList(oldIndexes, newIndexes);
+        Q_EMIT layoutChanged();
+    }
+}
+
+void WindowModel::onChangesCommitted(const WindowModelChanges &changes)
+{
+    const int oldCount = count();
+    m_applyingChanges = true;
+
+    changes->seal();
+    for (const auto &change : changes->changes()) {
+        switch (change.type) {
+        case WindowModelChangeSet::WindowAdded:
+            onWindowAdded(change.newWindow());
+            break;
+        case WindowModelChangeSet::WindowRemoved:
+            onWindowRemoved(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowReady:
+            onWindowReady(change.windowInfo);
+            break;
+        case WindowModelChangeSet::WindowMoved:
+            onWindowMoved(change.windowInfo, change.topLeft);
+            break;
+        case WindowModelChangeSet::WindowStateChanged:
+            onWindowStateChanged(change.windowInfo, change.state);
+            break;
+        case WindowModelChangeSet::WindowFocusChanged:
+            onWindowFocusChanged(change.windowInfo, change.focused);
+            break;
+        case WindowModelChangeSet::WindowsRaised:
+            onWindowsRaised(change.windows);
+            break;
+        case WindowModelChangeSet::WindowResized:
+        case WindowModelChangeSet::WindowRequestedRaise:
+        case WindowModelChangeSet::WindowMoveResizeStarted:
+        case WindowModelChangeSet::WindowMoveResizeEnded:
+            break;
+        }
+    }
+
+    m_applyingChanges = false;
+    if (count() != oldCount) {
+        Q_EMIT countChanged();
     }
 }
 
@@ -65,6 +65,7 @@ private Q_SLOTS:
     void onWindowStateChanged(const miral::WindowInfo &windowInfo, Mir::State state);
     void onWindowFocusChanged(const miral::WindowInfo &windowInfo, bool focused);
     void onWindowsRaised(const std::vector<miral::Window> &windows);
+    void onChangesCommitted(const qtmir::WindowModelChanges &changes);
 
 private:
     void connectToWindowModelNotifier(WindowModelNotifier *notifier);
@@ -77,6 +78,7 @@ private:
     QVector<MirSurface*> m_windowModel;
     WindowControllerInterface *m_windowController;
     MirSurface* m_inputMethodSurface{nullptr};
+    bool m_applyingChanges{false};
 };
 
 } // namespace qtmir
@@ -16,16 +16,40 @@
  */
 
 #include "cursor.h"
+#include "hardwarecursor.h"
 #include "logging.h"
 
 #include "mirsingleton.h"
 
+// Qt
+#include <QGuiApplication>
+#include <qpa/qplatformnativeinterface.h>
+
 // Unity API
 #include <unity/shell/application/MirMousePointerInterface.h>
 
 using namespace qtmir;
 
+namespace {
+
+HardwareCursor *findHardwareCursor()
+{
+    auto nativeInterface = qGuiApp->platformNativeInterface();
+    if (!nativeInterface) {
+        return nullptr;
+    }
+    return static_cast<HardwareCursor*>(nativeInterface->nativeResourceForIntegration("HardwareCursor"));
+}
+
+} // anonymous namespace
+
 Cursor::Cursor()
+    : Cursor(findHardwareCursor())
+{
+}
+
+Cursor::Cursor(HardwareCursor *hardwareCursor)
+    : m_hardwareCursor(hardwareCursor)
 {
     m_shapeToCursorName[Qt::ArrowCursor] = QStringLiteral("left_ptr");
     m_shapeToCursorName[Qt::UpArrowCursor] = QStringLiteral("up_arrow");
@@ -55,14 +79,15 @@ Cursor::Cursor()
 
 void Cursor::changeCursor(QCursor *windowCursor, QWindow * /*window*/)
 {
-    if (m_mousePointer.isNull()) {
+    if (m_mousePointer.isNull() && !m_hardwareCursor) {
         return;
     }
 
+    m_customCursor = QCursor();
+
     if (windowCursor) {
         if (windowCursor->pixmap().isNull()) {
             m_qtCursorName = m_shapeToCursorName.value(windowCursor->shape(), QStringLiteral("left_ptr"));
-            m_mousePointer->setCustomCursor(QCursor());
         } else {
             // Ensure we get different names for consecutive custom cursors.
             // The name doesn't have to be unique (ie, different from all custom cursor names generated so far),
@@ -70,11 +95,14 @@ void Cursor::changeCursor(QCursor *windowCursor, QWindow * /*window*/)
             // source image URL in the QML side which on is turn makes QML request the new cursor image.
             static quint8 serialNumber = 1;
             m_qtCursorName = QString("custom%1").arg(serialNumber++);
-            m_mousePointer->setCustomCursor(*windowCursor);
+            m_customCursor = *windowCursor;
         }
     } else {
         m_qtCursorName.clear();
-        m_mousePointer->setCustomCursor(QCursor());
+    }
+
+    if (m_mousePointer) {
+        m_mousePointer->setCustomCursor(m_customCursor);
     }
 
     updateMousePointerCursorName();
@@ -88,34 +116,83 @@ void Cursor::setMirCursorName(const QString &mirCursorName)
 
 void Cursor::setMousePointer(MirMousePointerInterface *mousePointer)
 {
-    QMutexLocker locker(&m_mutex);
-
     if (mousePointer && !m_mousePointer.isNull()) {
         qFatal("QPA mirserver: Only one MousePointer per screen is allowed!");
     }
 
+    if (m_mousePointer) {
+        disconnect(m_mousePointer, nullptr, this, nullptr);
+        if (m_hardwareCursor) {
+            m_mousePointer->setOpacity(m_mousePointerOpacity);
+        }
+    }
+
     m_mousePointer = mousePointer;
+
+    if (mousePointer) {
+        if (m_hardwareCursor) {
+            // Mir's cursor draws the pointer instead. The shell keeps control of the item's visibility,
+            // which the hardware cursor follows, so only its rendering is suppressed.
+            m_mousePointerOpacity = mousePointer->opacity();
+            mousePointer->setOpacity(0);
+        }
+        connect(mousePointer, &QQuickItem::visibleChanged, this, &Cursor::updatePointerVisible);
+        connect(mousePointer, &QObject::destroyed, this, &Cursor::updatePointerVisible);
+    }
+
+    // Whatever moved before this pointer came along is not its business
+    const MotionSnapshot snapshot = readMotion();
+    m_deliveredTotal = snapshot.total;
+    m_deliveredGeneration = snapshot.generation;
+
+    updatePointerVisible();
     updateMousePointerCursorName();
 }
 
+void Cursor::updatePointerVisible()
+{
+    if (m_hardwareCursor) {
+        // Mir's cursor is showing the pointer and events go straight to Qt
+        m_pointerVisible.store(false);
+        updateMousePointerCursorName();
+        return;
+    }
+
+    m_pointerVisible.store(m_mousePointer && m_mousePointer->isVisible());
+}
+
 bool Cursor::handleMouseEvent(ulong timestamp, QPointF movement, Qt::MouseButtons buttons,
         Qt::KeyboardModifiers modifiers)
 {
-    QMutexLocker locker(&m_mutex);
-
-    if (!m_mousePointer || !m_mousePointer->isVisible()) {
+    if (!m_pointerVisible.load()) {
         return false;
     }
 
+    m_inputTotal += movement;
+
+    if (buttons == m_inputButtons && modifiers == m_inputModifiers) {
+        publishMotion(timestamp);
+        if (!m_motionFlushQueued.exchange(true)) {
+            QMetaObject::invokeMethod(this, "flushMotion", Qt::QueuedConnection);
+        }
+        return true;
+    }
+
+    m_inputButtons = buttons;
+    m_inputModifiers = modifiers;
+    ++m_inputGeneration;
+    publishMotion(timestamp);
+
     // Must not be called directly as we're most likely not in Qt's GUI (main) thread.
-    bool ok = QMetaObject::invokeMethod(m_mousePointer, "handleMouseEvent", Qt::AutoConnection,
+    bool ok = QMetaObject::invokeMethod(this, "deliverButtonEvent", Qt::QueuedConnection,
         Q_ARG(ulong, timestamp),
-        Q_ARG(QPointF, movement),
+        Q_ARG(quint64, m_inputGeneration),
+        Q_ARG(QPointF, m_inputTotal),
         Q_ARG(Qt::MouseButtons, buttons),
         Q_ARG(Qt::KeyboardModifiers, modifiers));
 
     if (!ok) {
-        qCWarning(QTMIR_MIR_INPUT) << "Failed to invoke MousePointer::handleMouseEvent";
+        qCWarning(QTMIR_MIR_INPUT) << "Failed to queue MousePointer::handleMouseEvent";
     }
 
     return ok;
@@ -123,28 +200,130 @@ bool Cursor::handleMouseEvent(ulong timestamp, QPointF movement, Qt::MouseButton
 
 bool Cursor::handleWheelEvent(ulong timestamp, QPoint angleDelta, Qt::KeyboardModifiers modifiers)
 {
-    QMutexLocker locker(&m_mutex);
-
-    if (!m_mousePointer || !m_mousePointer->isVisible()) {
+    if (!m_pointerVisible.load()) {
         return false;
     }
 
+    ++m_inputGeneration;
+    publishMotion(timestamp);
+
     // Must not be called directly as we're most likely not in Qt's GUI (main) thread.
-    bool ok = QMetaObject::invokeMethod(m_mousePointer, "handleWheelEvent", Qt::AutoConnection,
+    bool ok = QMetaObject::invokeMethod(this, "deliverWheelEvent", Qt::QueuedConnection,
         Q_ARG(ulong, timestamp),
+        Q_ARG(quint64, m_inputGeneration),
+        Q_ARG(QPointF, m_inputTotal),
         Q_ARG(QPoint, angleDelta),
         Q_ARG(Qt::KeyboardModifiers, modifiers));
 
     if (!ok) {
-        qCWarning(QTMIR_MIR_INPUT) << "Failed to invoke MousePointer::handleMouseEvent";
+        qCWarning(QTMIR_MIR_INPUT) << "Failed to queue MousePointer::handleWheelEvent";
     }
 
     return ok;
 }
 
+void Cursor::publishMotion(ulong timestamp)
+{
+    const quint32 sequence = m_motionSequence.load(std::memory_order_relaxed);
+    m_motionSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_motionTotalX.store(m_inputTotal.x(), std::memory_order_relaxed);
+    m_motionTotalY.store(m_inputTotal.y(), std::memory_order_relaxed);
+    m_motionTimestamp.store(timestamp, std::memory_order_relaxed);
+    m_motionGeneration.store(m_inputGeneration, std::memory_order_relaxed);
+
+    m_motionSequence.store(sequence + 2, std::memory_order_release);
+}
+
+Cursor::MotionSnapshot Cursor::readMotion() const
+{
+    MotionSnapshot snapshot;
+    quint32 before, after;
+    do {
+        before = m_motionSequence.load(std::memory_order_acquire);
+        snapshot.total.setX(m_motionTotalX.load(std::memory_order_relaxed));
+        snapshot.total.setY(m_motionTotalY.load(std::memory_order_relaxed));
+        snapshot.timestamp = m_motionTimestamp.load(std::memory_order_relaxed);
+        snapshot.generation = m_motionGeneration.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_motionSequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return snapshot;
+}
+
+void Cursor::flushMotion()
+{
+    // Cleared before reading so that motion published from now on queues another flush
+    m_motionFlushQueued.store(false);
+    deliverPendingMotion();
+}
+
+void Cursor::deliverPendingMotion()
+{
+    const MotionSnapshot snapshot = readMotion();
+    if (snapshot.generation > m_deliveredGeneration) {
+        // A button or wheel event is still in the queue. Motion up to it travels with it
+        // and it flushes whatever follows once delivered.
+        return;
+    }
+    deliverMotion(snapshot.timestamp, snapshot.total);
+}
+
+void Cursor::deliverMotion(ulong timestamp, const QPointF &total)
+{
+    const QPointF movement = total - m_deliveredTotal;
+    if (movement.isNull()) {
+        return;
+    }
+    m_deliveredTotal = total;
+
+    if (m_mousePointer) {
+        m_mousePointer->handleMouseEvent(timestamp, movement, m_deliveredButtons, m_deliveredModifiers);
+    }
+}
+
+void Cursor::deliverButtonEvent(ulong timestamp, quint64 generation, QPointF total,
+        Qt::MouseButtons buttons, Qt::KeyboardModifiers modifiers)
+{
+    if (generation <= m_deliveredGeneration) {
+        return; // queued before the current MousePointer was set
+    }
+
+    const QPointF movement = total - m_deliveredTotal;
+    m_deliveredTotal = total;
+    m_deliveredGeneration = generation;
+    m_deliveredButtons = buttons;
+    m_deliveredModifiers = modifiers;
+
+    if (m_mousePointer) {
+        m_mousePointer->handleMouseEvent(timestamp, movement, buttons, modifiers);
+    }
+
+    deliverPendingMotion();
+}
+
+void Cursor::deliverWheelEvent(ulong timestamp, quint64 generation, QPointF total,
+        QPoint angleDelta, Qt::KeyboardModifiers modifiers)
+{
+    if (generation <= m_deliveredGeneration) {
+        return; // queued before the current MousePointer was set
+    }
+
+    // The wheel acts at wherever the pointer was when it turned
+    deliverMotion(timestamp, total);
+    m_deliveredGeneration = generation;
+
+    if (m_mousePointer) {
+        m_mousePointer->handleWheelEvent(timestamp, angleDelta, modifiers);
+    }
+
+    deliverPendingMotion();
+}
+
 void Cursor::setPos(const QPoint &pos)
 {
-    if (!m_mousePointer) {
+    if (!m_mousePointer || m_hardwareCursor) {
         QPlatformCursor::setPos(pos);
         return;
     }
@@ -160,7 +339,7 @@ void Cursor::setPos(const QPoint &pos)
 
 QPoint Cursor::pos() const
 {
-    if (m_mousePointer) {
+    if (m_mousePointer && !m_hardwareCursor) {
         return m_mousePointer->mapToItem(nullptr, QPointF(0, 0)).toPoint();
     } else {
         return QPlatformCursor::pos();
@@ -169,17 +348,30 @@ QPoint Cursor::pos() const
 
 void Cursor::updateMousePointerCursorName()
 {
-    if (!m_mousePointer) {
-        return;
-    }
-
+    QString cursorName;
     if (m_mirCursorName.isEmpty()) {
         if (m_qtCursorName.isEmpty()) {
-            m_mousePointer->setCursorName(QStringLiteral("left_ptr"));
+            cursorName = QStringLiteral("left_ptr");
         } else {
-            m_mousePointer->setCursorName(m_qtCursorName);
+            cursorName = m_qtCursorName;
         }
     } else {
-        m_mousePointer->setCursorName(m_mirCursorName);
+        cursorName = m_mirCursorName;
+    }
+
+    if (m_mousePointer) {
+        m_mousePointer->setCursorName(cursorName);
+    }
+
+    if (m_hardwareCursor) {
+        if (m_mousePointer && !m_mousePointer->isVisible()) {
+            m_hardwareCursor->hide();
+        } else if (cursorName == m_qtCursorName && !m_customCursor.pixmap().isNull()) {
+            m_hardwareCursor->setCursorImage(m_customCursor.pixmap().toImage(), m_customCursor.hotSpot());
+        } else if (cursorName == QLatin1String("blank")) {
+            m_hardwareCursor->hide();
+        } else {
+            m_hardwareCursor->setNamedCursor(cursorName.toLatin1());
+        }
     }
 }
@@ -18,19 +18,23 @@
 #ifndef QTMIR_CURSOR_H
 #define QTMIR_CURSOR_H
 
-#include <QMutex>
 #include <QPointer>
 
+#include <atomic>
+
 // Unity API
 #include <unity/shell/application/MirPlatformCursor.h>
 
 namespace qtmir {
 
+class HardwareCursor;
+
 class Cursor : public MirPlatformCursor
 {
     Q_OBJECT
 public:
     Cursor();
+    explicit Cursor(HardwareCursor *hardwareCursor);
 
     // Called form Mir input thread
     bool handleMouseEvent(ulong timestamp, QPointF movement, Qt::MouseButtons buttons,
@@ -53,11 +57,68 @@ public:
 
 private Q_SLOTS:
     void setMirCursorName(const QString &mirCursorName);
+    void updatePointerVisible();
+
+    // Called from Qt's GUI thread, queued from the Mir input thread
+    void flushMotion();
+    void deliverButtonEvent(ulong timestamp, quint64 generation, QPointF total,
+            Qt::MouseButtons buttons, Qt::KeyboardModifiers modifiers);
+    void deliverWheelEvent(ulong timestamp, quint64 generation, QPointF total,
+            QPoint angleDelta, Qt::KeyboardModifiers modifiers);
 
 private:
+    /*
+     * Pointer motion is not posted event by event. The input thread accumulates it into
+     * a mailbox and the GUI thread picks up whatever built up since its last look, so a
+     * burst of motion costs at most one queued call per event loop iteration.
+     *
+     * The mailbox holds the total movement so far and the generation of the last
+     * discrete event (button/modifier change or wheel). Discrete events are still
+     * queued individually, carrying the total at the time they happened, so they are
+     * delivered in order with respect to motion.
+     *
+     * It is a sequence lock: the writer never waits, the reader retries on a torn read.
+     */
+    struct MotionSnapshot {
+        QPointF total;
+        ulong timestamp{0};
+        quint64 generation{0};
+    };
+    void publishMotion(ulong timestamp);
+    MotionSnapshot readMotion() const;
+    void deliverPendingMotion();
+    void deliverMotion(ulong timestamp, const QPointF &total);
+
     void updateMousePointerCursorName();
-    QMutex m_mutex;
+
+    // Set when the pointer image goes to Mir's cursor plane instead of the QML MousePointer
+    HardwareCursor *const m_hardwareCursor;
+    QCursor m_customCursor;
+
     QPointer<MirMousePointerInterface> m_mousePointer;
+    qreal m_mousePointerOpacity{1}; // what to restore once the hardware cursor no longer stands in for it
+    std::atomic<bool> m_pointerVisible{false};
+
+    // Mailbox, written by the input thread only
+    std::atomic<quint32> m_motionSequence{0};
+    std::atomic<double> m_motionTotalX{0};
+    std::atomic<double> m_motionTotalY{0};
+    std::atomic<ulong> m_motionTimestamp{0};
+    std::atomic<quint64> m_motionGeneration{0};
+    std::atomic<bool> m_motionFlushQueued{false};
+
+    // Input thread state
+    QPointF m_inputTotal;
+    quint64 m_inputGeneration{0};
+    Qt::MouseButtons m_inputButtons{Qt::NoButton};
+    Qt::KeyboardModifiers m_inputModifiers{Qt::NoModifier};
+
+    // GUI thread state: what has been handed to m_mousePointer so far
+    QPointF m_deliveredTotal;
+    quint64 m_deliveredGeneration{0};
+    Qt::MouseButtons m_deliveredButtons{Qt::NoButton};
+    Qt::KeyboardModifiers m_deliveredModifiers{Qt::NoModifier};
+
     QMap<int,QString> m_shapeToCursorName;
     QString m_qtCursorName;
     QString m_mirCursorName;
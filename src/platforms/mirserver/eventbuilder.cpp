@@ -132,56 +132,31 @@ mir::EventUPtr EventBuilder::makeMirEvent(QInputEvent *qtEvent, int x, int y, Mi
 {
     MirPointerAction action = mirPointerActionFromMouseEventType(qtEvent->type());
 
-    auto timestamp = uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(qtEvent->timestamp()));
     auto modifiers = getMirModifiersFromQt(qtEvent->modifiers());
 
-    float relativeX = 0.;
-    float relativeY = 0.;
-    MirInputDeviceId deviceId = 0;
-    std::vector<uint8_t> cookie{};
-
     // Timestamp will be zero in case of synthetic events. Particularly synthetic QHoverEvents caused
     // by item movement under a stationary mouse pointer.
-    if (qtEvent->timestamp() != 0) {
-        auto eventInfo = findInfo(qtEvent->timestamp());
-        if (eventInfo) {
-            relativeX = eventInfo->relativeX;
-            relativeY = eventInfo->relativeY;
-            deviceId = eventInfo->deviceId;
-            cookie = eventInfo->cookie;
-        } else {
-            qCWarning(QTMIR_MIR_INPUT) << "EventBuilder::makeMirEvent didn't find EventInfo with timestamp" << qtEvent->timestamp();
-        }
-    }
+    const EventInfo &eventInfo = infoFor(qtEvent->timestamp());
+    auto timestamp = eventTime(eventInfo, qtEvent->timestamp());
 
-    return mir::events::make_event(deviceId, timestamp, cookie, modifiers, action,
-                                   buttons, x, y, 0 /*hscroll*/, 0 /*vscroll*/, relativeX, relativeY);
+    return mir::events::make_event(eventInfo.deviceId, timestamp, eventInfo.cookie, modifiers, action,
+                                   buttons, x, y, 0 /*hscroll*/, 0 /*vscroll*/,
+                                   eventInfo.relativeX, eventInfo.relativeY);
 }
 
 mir::EventUPtr EventBuilder::makeMirEvent(QWheelEvent *qtEvent)
 {
-    auto timestamp = uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(qtEvent->timestamp()));
     auto modifiers = getMirModifiersFromQt(qtEvent->modifiers());
     auto buttons = getMirButtonsFromQt(qtEvent->buttons());
 
-    MirInputDeviceId deviceId = 0;
-    std::vector<uint8_t> cookie{};
-
     QPointF mirScroll(qtEvent->angleDelta());
     // QWheelEvent::DefaultDeltasPerStep = 120 but not defined on vivid
     mirScroll /= 120.0f;
 
-    if (qtEvent->timestamp() != 0) {
-        auto eventInfo = findInfo(qtEvent->timestamp());
-        if (eventInfo) {
-            deviceId = eventInfo->deviceId;
-            cookie = eventInfo->cookie;
-        } else {
-            qCWarning(QTMIR_MIR_INPUT) << "EventBuilder::makeMirEvent didn't find EventInfo with timestamp" << qtEvent->timestamp();
-        }
-    }
+    const EventInfo &eventInfo = infoFor(qtEvent->timestamp());
+    auto timestamp = eventTime(eventInfo, qtEvent->timestamp());
 
-    return mir::events::make_event(deviceId, timestamp, cookie, modifiers, mir_pointer_action_motion,
+    return mir::events::make_event(eventInfo.deviceId, timestamp, eventInfo.cookie, modifiers, mir_pointer_action_motion,
                                    buttons, qtEvent->x(), qtEvent->y(),
                                    mirScroll.x(), mirScroll.y(),
                                    0, 0);
@@ -203,21 +178,11 @@ mir::EventUPtr EventBuilder::makeMirEvent(QKeyEvent *qtEvent)
     }
     if (qtEvent->isAutoRepeat())
         action = mir_keyboard_action_repeat;
-    MirInputDeviceId deviceId = 0;
-    std::vector<uint8_t> cookie{};
 
-    if (qtEvent->timestamp() != 0) {
-        auto eventInfo = findInfo(qtEvent->timestamp());
-        if (eventInfo) {
-            deviceId = eventInfo->deviceId;
-            cookie = eventInfo->cookie;
-        } else {
-            qCWarning(QTMIR_MIR_INPUT) << "EventBuilder::makeMirEvent didn't find EventInfo with timestamp" << qtEvent->timestamp();
-        }
-    }
+    const EventInfo &eventInfo = infoFor(qtEvent->timestamp());
 
-    return mir::events::make_event(deviceId, uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(qtEvent->timestamp())),
-                           cookie, action, qtEvent->nativeVirtualKey(),
+    return mir::events::make_event(eventInfo.deviceId, eventTime(eventInfo, qtEvent->timestamp()),
+                           eventInfo.cookie, action, qtEvent->nativeVirtualKey(),
                            qtEvent->nativeScanCode(),
                            qtEvent->nativeModifiers());
 }
@@ -227,25 +192,14 @@ mir::EventUPtr EventBuilder::makeMirEvent(Qt::KeyboardModifiers qmods,
                             Qt::TouchPointStates /* qtTouchPointStates */,
                             ulong qtTimestamp)
 {
-    MirInputDeviceId deviceId = 0;
-    std::vector<uint8_t> cookie{};
-
-    if (qtTimestamp != 0) {
-        auto eventInfo = findInfo(qtTimestamp);
-        if (eventInfo) {
-            deviceId = eventInfo->deviceId;
-            cookie = eventInfo->cookie;
-        } else {
-            qCWarning(QTMIR_MIR_INPUT) << "EventBuilder::makeMirEvent didn't find EventInfo with timestamp" << qtTimestamp;
-        }
-    }
+    const EventInfo &eventInfo = infoFor(qtTimestamp);
 
     auto modifiers = getMirModifiersFromQt(qmods);
-    auto ev = mir::events::make_event(deviceId, uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(qtTimestamp)),
-                                      cookie, modifiers);
+    auto ev = mir::events::make_event(eventInfo.deviceId, eventTime(eventInfo, qtTimestamp),
+                                      eventInfo.cookie, modifiers);
 
     for (int i = 0; i < qtTouchPoints.count(); ++i) {
-        auto touchPoint = qtTouchPoints.at(i);
+        const auto &touchPoint = qtTouchPoints.at(i);
         auto id = touchPoint.id();
 
         MirTouchAction action = mir_touch_action_change;
@@ -283,9 +237,37 @@ EventBuilder::EventInfo *EventBuilder::findInfo(ulong qtTimestamp)
     return nullptr;
 }
 
+const EventBuilder::EventInfo &EventBuilder::infoFor(ulong qtTimestamp)
+{
+    if (qtTimestamp != 0) {
+        auto eventInfo = findInfo(qtTimestamp);
+        if (eventInfo) {
+            return *eventInfo;
+        }
+        qCWarning(QTMIR_MIR_INPUT) << "EventBuilder::makeMirEvent didn't find EventInfo with timestamp" << qtTimestamp;
+    }
+    return m_blankInfo;
+}
+
+std::chrono::nanoseconds EventBuilder::eventTime(const EventInfo &eventInfo, ulong qtTimestamp)
+{
+    // Prefer the original time, as the Qt one has only millisecond resolution
+    if (eventInfo.mirTimestamp.count() != 0) {
+        return eventInfo.mirTimestamp;
+    }
+    return uncompressTimestamp<qtmir::Timestamp>(qtmir::Timestamp(qtTimestamp));
+}
+
+std::chrono::nanoseconds EventBuilder::mirEventTime(ulong qtTimestamp)
+{
+    auto eventInfo = findInfo(qtTimestamp);
+    return eventTime(eventInfo ? *eventInfo : m_blankInfo, qtTimestamp);
+}
+
 void EventBuilder::EventInfo::store(const MirInputEvent *iev, ulong qtTimestamp)
 {
     this->qtTimestamp = qtTimestamp;
+    mirTimestamp = std::chrono::nanoseconds(mir_input_event_get_event_time(iev));
     deviceId = mir_input_event_get_device_id(iev);
     if (mir_input_event_has_cookie(iev))
     {
@@ -301,5 +283,8 @@ void EventBuilder::EventInfo::store(const MirInputEvent *iev, ulong qtTimestamp)
         auto pev = mir_input_event_get_pointer_event(iev);
         relativeX = mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_x);
         relativeY = mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_y);
+    } else {
+        relativeX = 0;
+        relativeY = 0;
     }
 }
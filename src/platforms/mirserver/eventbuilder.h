@@ -72,8 +72,10 @@ public:
     class EventInfo {
     public:
         void store(const MirInputEvent *mirInputEvent, ulong qtTimestamp);
-        ulong qtTimestamp;
-        MirInputDeviceId deviceId;
+        ulong qtTimestamp{0};
+        std::chrono::nanoseconds mirTimestamp{0};
+        MirInputDeviceId deviceId{0};
+        // resized in place, so once warmed up the ring buffer below no longer allocates
         std::vector<uint8_t> cookie;
         float relativeX{0};
         float relativeY{0};
@@ -81,9 +83,22 @@ public:
 
     EventInfo *findInfo(ulong qtTimestamp);
 
+    /*
+        The time of the MirInputEvent that originated the Qt event with the given qtTimestamp,
+        at full resolution. Used to correlate input events across qtmir in traces.
+     */
+    std::chrono::nanoseconds mirEventTime(ulong qtTimestamp);
+
 private:
     mir::EventUPtr makeMirEvent(QInputEvent *qtEvent, int x, int y, MirPointerButtons buttons);
 
+    /*
+        Returns the stored info for the given qtTimestamp, or a blank one if there's none.
+        Handed out by reference so that building a MirEvent doesn't copy the cookie.
+     */
+    const EventInfo &infoFor(ulong qtTimestamp);
+    std::chrono::nanoseconds eventTime(const EventInfo &eventInfo, ulong qtTimestamp);
+
 
     /*
       Ring buffer that stores information on recent MirInputEvents that cannot be carried by QInputEvents.
@@ -100,6 +115,8 @@ private:
     int m_nextIndex{0};
     int m_count{0};
 
+    const EventInfo m_blankInfo{};
+
     static EventBuilder *m_instance;
 };
 
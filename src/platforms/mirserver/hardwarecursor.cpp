@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "hardwarecursor.h"
+#include "logging.h"
+
+// mir
+#include <mir/graphics/cursor.h>
+#include <mir/graphics/cursor_image.h>
+#include <mir/input/cursor_images.h>
+
+using namespace qtmir;
+
+namespace {
+
+class QImageCursor : public mir::graphics::CursorImage
+{
+public:
+    QImageCursor(const QImage &image, const QPoint &hotspot)
+        : m_image(image.convertToFormat(QImage::Format_ARGB32_Premultiplied))
+        , m_hotspot(hotspot) {}
+
+    const void *as_argb_8888() const override { return m_image.constBits(); }
+    mir::geometry::Size size() const override { return {m_image.width(), m_image.height()}; }
+    mir::geometry::Displacement hotspot() const override { return {m_hotspot.x(), m_hotspot.y()}; }
+
+private:
+    const QImage m_image;
+    const QPoint m_hotspot;
+};
+
+} // anonymous namespace
+
+HardwareCursor::HardwareCursor(const std::shared_ptr<mir::graphics::Cursor> &cursor,
+                               const std::shared_ptr<mir::input::CursorImages> &cursorImages)
+    : m_cursor(cursor)
+    , m_cursorImages(cursorImages)
+{
+}
+
+bool HardwareCursor::isRequested()
+{
+    return qgetenv("QTMIR_HARDWARE_CURSOR") == "1";
+}
+
+void HardwareCursor::setNamedCursor(const QByteArray &name)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (name == m_currentName && m_currentImage) {
+        return;
+    }
+
+    auto image = m_cursorImages->image(name.toStdString(), mir::input::default_cursor_size);
+    if (!image) {
+        qCWarning(QTMIR_MIR_INPUT) << "HardwareCursor: no image for cursor" << name << "in the theme";
+        image = m_cursorImages->image("left_ptr", mir::input::default_cursor_size);
+    }
+
+    m_currentName = name;
+    show(image);
+}
+
+void HardwareCursor::setCursorImage(const QImage &image, const QPoint &hotspot)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_currentName.clear();
+    show(image.isNull() ? nullptr : std::make_shared<QImageCursor>(image, hotspot));
+}
+
+void HardwareCursor::hide()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_currentName.clear();
+    show(nullptr);
+}
+
+void HardwareCursor::show(const std::shared_ptr<mir::graphics::CursorImage> &image)
+{
+    // Mir's cursor may keep referring to the image, so it is kept alive until replaced
+    m_currentImage = image;
+
+    if (image) {
+        m_cursor->show(*image);
+    } else {
+        m_cursor->hide();
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef QTMIR_HARDWARECURSOR_H
+#define QTMIR_HARDWARECURSOR_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QPoint>
+
+#include <memory>
+
+namespace mir {
+namespace graphics { class Cursor; class CursorImage; }
+namespace input { class CursorImages; }
+}
+
+namespace qtmir {
+
+/*
+    Drives Mir's cursor (normally a hardware cursor plane) with the image qtmir::Cursor
+    wants shown, instead of having the shell draw the pointer in QML.
+
+    Mir keeps moving the cursor itself, so pointer motion over a static scene does not
+    cause any Qt rendering at all.
+
+    Enabled by setting QTMIR_HARDWARE_CURSOR=1. Only do so on platforms that have cursor
+    planes: Mir's software cursor fallback is not drawn by the Qt compositor.
+*/
+class HardwareCursor
+{
+public:
+    HardwareCursor(const std::shared_ptr<mir::graphics::Cursor> &cursor,
+                   const std::shared_ptr<mir::input::CursorImages> &cursorImages);
+
+    static bool isRequested();
+
+    // Can be called from any thread
+    void setNamedCursor(const QByteArray &name);
+    void setCursorImage(const QImage &image, const QPoint &hotspot);
+    void hide();
+
+private:
+    void show(const std::shared_ptr<mir::graphics::CursorImage> &image);
+
+    const std::shared_ptr<mir::graphics::Cursor> m_cursor;
+    const std::shared_ptr<mir::input::CursorImages> m_cursorImages;
+
+    QMutex m_mutex;
+    QByteArray m_currentName;
+    std::shared_ptr<mir::graphics::CursorImage> m_currentImage;
+};
+
+} // namespace qtmir
+
+#endif // QTMIR_HARDWARECURSOR_H
@@ -66,7 +66,6 @@ void MirInputDeviceObserver::applyKeymap(const std::shared_ptr<mi::Device> &devi
             variant = stringList.at(1);
         }
 
-        qCDebug(QTMIR_MIR_KEYMAP) << "Applying keymap" <<  layout << variant << "on" << device->id() << QString::fromStdString(device->name());
         MirKeyboardConfig oldConfig;
         mi::Keymap keymap;
         if (device->keyboard_configuration().is_set()) { // preserve the model and options
@@ -77,6 +76,16 @@ void MirInputDeviceObserver::applyKeymap(const std::shared_ptr<mi::Device> &devi
         keymap.layout = layout.toStdString();
         keymap.variant = variant.toStdString();
 
+        // Mir compiles a new keymap on each apply, don't make it redo the one the device already has
+        if (device->keyboard_configuration().is_set()
+                && oldConfig.device_keymap().layout == keymap.layout
+                && oldConfig.device_keymap().variant == keymap.variant) {
+            qCDebug(QTMIR_MIR_KEYMAP) << "Keymap" << layout << variant << "already set on" << device->id();
+            return;
+        }
+
+        qCDebug(QTMIR_MIR_KEYMAP) << "Applying keymap" <<  layout << variant << "on" << device->id() << QString::fromStdString(device->name());
+
         try
         {
             device->apply_keyboard_configuration(std::move(keymap));
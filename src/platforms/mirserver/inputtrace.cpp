@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "inputtrace.h"
+#include "logging.h"
+#include "qteventfeeder.h"
+
+// mir
+#include <mir_toolkit/mir_cookie.h>
+
+#include <thread>
+
+using namespace qtmir;
+namespace mev = mir::events;
+
+namespace {
+
+const quint32 TraceMagic = 0x514d4954; // "QMIT"
+const quint16 TraceVersion = 1;
+
+void setUpStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+}
+
+QByteArray cookieOf(const MirInputEvent *event)
+{
+    QByteArray cookie;
+    if (mir_input_event_has_cookie(event)) {
+        auto mirCookie = mir_input_event_get_cookie(event);
+        cookie.resize(mir_cookie_buffer_size(mirCookie));
+        mir_cookie_to_buffer(mirCookie, cookie.data(), cookie.size());
+        mir_cookie_release(mirCookie);
+    }
+    return cookie;
+}
+
+} // anonymous namespace
+
+InputTraceWriter::InputTraceWriter(const QString &fileName)
+    : m_file(fileName)
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(QTMIR_MIR_INPUT) << "Could not open input trace" << fileName << "for writing:" << m_file.errorString();
+        return;
+    }
+
+    m_pendingBuffer.setBuffer(&m_pending);
+    m_pendingBuffer.open(QIODevice::WriteOnly);
+    m_stream.setDevice(&m_pendingBuffer);
+    setUpStream(m_stream);
+    m_stream << TraceMagic << TraceVersion;
+
+    m_writerThread = std::thread(&InputTraceWriter::writeLoop, this);
+}
+
+InputTraceWriter::~InputTraceWriter()
+{
+    if (m_writerThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wakeWriter.notify_one();
+        m_writerThread.join();
+    }
+}
+
+constexpr std::chrono::milliseconds InputTraceWriter::FlushInterval;
+
+bool InputTraceWriter::isOpen() const
+{
+    // m_file itself belongs to the writer thread
+    return m_writerThread.joinable();
+}
+
+// Runs in m_writerThread, so the input thread never waits on the disk
+void InputTraceWriter::writeLoop()
+{
+    bool stopping = false;
+    while (!stopping) {
+        QByteArray data;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeWriter.wait_for(lock, FlushInterval, [this]() {
+                return m_stopping || m_pending.size() >= MaxPending;
+            });
+            stopping = m_stopping;
+
+            data.swap(m_pending);
+            m_pendingBuffer.seek(0);
+        }
+
+        if (!data.isEmpty()) {
+            m_file.write(data);
+            m_file.flush();
+        }
+    }
+    m_file.close();
+}
+
+void InputTraceWriter::record(const MirInputEvent *event)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!m_started) {
+        m_startTime = now;
+        m_started = true;
+    }
+
+    const MirInputEventType type = mir_input_event_get_type(event);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_stream << quint8(type)
+             << qint64(mir_input_event_get_device_id(event))
+             << qint64(mir_input_event_get_event_time(event))
+             << qint64(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_startTime).count())
+             << cookieOf(event);
+
+    switch (type) {
+    case mir_input_event_type_key: {
+        auto kev = mir_input_event_get_keyboard_event(event);
+        m_stream << quint32(mir_keyboard_event_modifiers(kev))
+                 << qint32(mir_keyboard_event_action(kev))
+                 << quint32(mir_keyboard_event_key_code(kev))
+                 << qint32(mir_keyboard_event_scan_code(kev));
+        break;
+    }
+    case mir_input_event_type_touch: {
+        auto tev = mir_input_event_get_touch_event(event);
+        const quint8 pointCount = mir_touch_event_point_count(tev);
+        m_stream << quint32(mir_touch_event_modifiers(tev)) << pointCount;
+        for (quint8 i = 0; i < pointCount; ++i) {
+            m_stream << qint32(mir_touch_event_id(tev, i))
+                     << qint32(mir_touch_event_action(tev, i))
+                     << qint32(mir_touch_event_tooltype(tev, i))
+                     << mir_touch_event_axis_value(tev, i, mir_touch_axis_x)
+                     << mir_touch_event_axis_value(tev, i, mir_touch_axis_y)
+                     << mir_touch_event_axis_value(tev, i, mir_touch_axis_pressure)
+                     << mir_touch_event_axis_value(tev, i, mir_touch_axis_touch_major)
+                     << mir_touch_event_axis_value(tev, i, mir_touch_axis_touch_minor)
+                     << mir_touch_event_axis_value(tev, i, mir_touch_axis_size);
+        }
+        break;
+    }
+    case mir_input_event_type_pointer: {
+        auto pev = mir_input_event_get_pointer_event(event);
+        m_stream << quint32(mir_pointer_event_modifiers(pev))
+                 << qint32(mir_pointer_event_action(pev))
+                 << quint32(mir_pointer_event_buttons(pev))
+                 << mir_pointer_event_axis_value(pev, mir_pointer_axis_x)
+                 << mir_pointer_event_axis_value(pev, mir_pointer_axis_y)
+                 << mir_pointer_event_axis_value(pev, mir_pointer_axis_hscroll)
+                 << mir_pointer_event_axis_value(pev, mir_pointer_axis_vscroll)
+                 << mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_x)
+                 << mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_y);
+        break;
+    }
+    default:
+        break;
+    }
+
+    const bool wakeWriter = m_pending.size() >= MaxPending;
+    lock.unlock();
+    if (wakeWriter) {
+        m_wakeWriter.notify_one();
+    }
+}
+
+InputTraceReader::InputTraceReader(const QString &fileName)
+    : m_file(fileName)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qCWarning(QTMIR_MIR_INPUT) << "Could not open input trace" << fileName << ":" << m_file.errorString();
+        return;
+    }
+
+    m_stream.setDevice(&m_file);
+    setUpStream(m_stream);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    m_stream >> magic >> version;
+    if (magic != TraceMagic || version != TraceVersion) {
+        qCWarning(QTMIR_MIR_INPUT) << fileName << "is not a supported input trace";
+        return;
+    }
+
+    m_valid = true;
+}
+
+bool InputTraceReader::isValid() const
+{
+    return m_valid;
+}
+
+bool InputTraceReader::readNext(Entry &entry)
+{
+    if (!m_valid || m_stream.atEnd()) {
+        return false;
+    }
+
+    quint8 type;
+    qint64 deviceId, eventTime, captureTime;
+    QByteArray cookieBytes;
+    quint32 modifiers;
+    m_stream >> type >> deviceId >> eventTime >> captureTime >> cookieBytes >> modifiers;
+
+    const std::vector<uint8_t> cookie(cookieBytes.cbegin(), cookieBytes.cend());
+    const std::chrono::nanoseconds timestamp{eventTime};
+
+    switch (type) {
+    case mir_input_event_type_key: {
+        qint32 action, scanCode;
+        quint32 keysym;
+        m_stream >> action >> keysym >> scanCode;
+        entry.event = mev::make_event(deviceId, timestamp, cookie, MirKeyboardAction(action), keysym, scanCode,
+                                      MirInputEventModifiers(modifiers));
+        break;
+    }
+    case mir_input_event_type_touch: {
+        quint8 pointCount;
+        m_stream >> pointCount;
+        entry.event = mev::make_event(deviceId, timestamp, cookie, MirInputEventModifiers(modifiers));
+        for (quint8 i = 0; i < pointCount; ++i) {
+            qint32 id, action, tooltype;
+            float x, y, pressure, major, minor, size;
+            m_stream >> id >> action >> tooltype >> x >> y >> pressure >> major >> minor >> size;
+            mev::add_touch(*entry.event, id, MirTouchAction(action), MirTouchTooltype(tooltype),
+                           x, y, pressure, major, minor, size);
+        }
+        break;
+    }
+    case mir_input_event_type_pointer: {
+        qint32 action;
+        quint32 buttons;
+        float x, y, hscroll, vscroll, relativeX, relativeY;
+        m_stream >> action >> buttons >> x >> y >> hscroll >> vscroll >> relativeX >> relativeY;
+        entry.event = mev::make_event(deviceId, timestamp, cookie, MirInputEventModifiers(modifiers),
+                                      MirPointerAction(action), MirPointerButtons(buttons),
+                                      x, y, hscroll, vscroll, relativeX, relativeY);
+        break;
+    }
+    default:
+        qCWarning(QTMIR_MIR_INPUT) << "Unknown event type" << type << "in input trace";
+        m_valid = false;
+        return false;
+    }
+
+    if (m_stream.status() != QDataStream::Ok) {
+        qCWarning(QTMIR_MIR_INPUT) << "Truncated input trace";
+        m_valid = false;
+        return false;
+    }
+
+    entry.captureTime = std::chrono::nanoseconds(captureTime);
+    return true;
+}
+
+int qtmir::replayInputTrace(InputTraceReader &reader, const std::function<void(const MirEvent &)> &dispatch,
+                            double speed)
+{
+    int count = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    InputTraceReader::Entry entry;
+    while (reader.readNext(entry)) {
+        if (speed > 0) {
+            const auto due = startTime + std::chrono::duration_cast<std::chrono::nanoseconds>(entry.captureTime / speed);
+            std::this_thread::sleep_until(due);
+        }
+        dispatch(*entry.event);
+        ++count;
+    }
+
+    return count;
+}
+
+int qtmir::replayInputTrace(InputTraceReader &reader, QtEventFeeder &eventFeeder, double speed)
+{
+    return replayInputTrace(reader, [&eventFeeder](const MirEvent &event) { eventFeeder.dispatch(event); },
+                            speed);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef QTMIR_INPUTTRACE_H
+#define QTMIR_INPUTTRACE_H
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <mir/events/event_builders.h>
+
+class QtEventFeeder;
+
+namespace qtmir {
+
+/*
+    Records the input events reaching the window manager into a compact binary file, so that a real
+    input session can later be replayed to measure the input path reproducibly.
+
+    File layout (QDataStream, Qt 5.6 format, single precision floats):
+        header: quint32 magic, quint16 version
+        record: quint8 MirInputEventType, qint64 device id, qint64 event time (ns),
+                qint64 capture time (ns since the first record), QByteArray cookie,
+                quint32 modifiers, followed by the payload of the event type:
+            key:     qint32 action, quint32 keysym, qint32 scan code
+            touch:   quint8 point count, then per point qint32 id, qint32 action, qint32 tool type,
+                     float x, y, pressure, touch major, touch minor, size
+            pointer: qint32 action, quint32 buttons, float x, y, hscroll, vscroll, relative x, relative y
+
+    Recording is enabled by pointing QTMIR_INPUT_TRACE to the file to write.
+
+    Records are serialized into memory on the calling thread and written out by a thread of the
+    writer's own, every FlushInterval or once MaxPending bytes have built up, and on destruction.
+ */
+class InputTraceWriter
+{
+public:
+    explicit InputTraceWriter(const QString &fileName);
+    ~InputTraceWriter();
+
+    bool isOpen() const;
+
+    // Called from the Mir input thread
+    void record(const MirInputEvent *event);
+
+private:
+    enum { MaxPending = 64 * 1024 };
+    static constexpr std::chrono::milliseconds FlushInterval{250};
+
+    void writeLoop();
+
+    QFile m_file;
+    std::chrono::steady_clock::time_point m_startTime;
+    bool m_started{false};
+
+    // Records not written to m_file yet
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWriter;
+    QByteArray m_pending;
+    QBuffer m_pendingBuffer;
+    QDataStream m_stream;
+    bool m_stopping{false};
+
+    std::thread m_writerThread;
+};
+
+class InputTraceReader
+{
+public:
+    explicit InputTraceReader(const QString &fileName);
+
+    bool isValid() const;
+
+    struct Entry {
+        std::chrono::nanoseconds captureTime{0};
+        mir::EventUPtr event;
+    };
+
+    // Returns false at the end of the trace or on a malformed record
+    bool readNext(Entry &entry);
+
+private:
+    QFile m_file;
+    QDataStream m_stream;
+    bool m_valid{false};
+};
+
+/*
+    Feeds a recorded trace back, keeping the original spacing between events divided by speed.
+    A speed of 0 replays as fast as possible.
+
+    Returns the number of events replayed.
+ */
+int replayInputTrace(InputTraceReader &reader, const std::function<void(const MirEvent &)> &dispatch,
+                     double speed = 1.0);
+int replayInputTrace(InputTraceReader &reader, QtEventFeeder &eventFeeder, double speed = 1.0);
+
+} // namespace qtmir
+
+#endif // QTMIR_INPUTTRACE_H
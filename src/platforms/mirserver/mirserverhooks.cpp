@@ -18,6 +18,7 @@
 
 #include "mirserverhooks.h"
 
+#include "hardwarecursor.h"
 #include "mircursorimages.h"
 #include "promptsessionlistener.h"
 #include "screenscontroller.h"
@@ -32,6 +33,9 @@
 #include <mir/input/input_device_hub.h>
 #include <mir/input/input_device_observer.h>
 
+// miral
+#include <miral/cursor_theme.h>
+
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 
@@ -76,6 +80,20 @@ struct HiddenCursorWrapper : mg::Cursor
 private:
     std::shared_ptr<mg::Cursor> const wrapped;
 };
+
+// Leaves the image to qtmir::HardwareCursor but lets Mir keep moving the cursor
+struct ShellImageCursorWrapper : mg::Cursor
+{
+    ShellImageCursorWrapper(std::shared_ptr<mg::Cursor> const& wrapped) :
+        wrapped{wrapped} { wrapped->hide(); }
+    void show() override { }
+    void show(mg::CursorImage const&) override { }
+    void hide() override { }
+
+    void move_to(mir::geometry::Point position) override { wrapped->move_to(position); }
+
+    std::shared_ptr<mg::Cursor> const wrapped;
+};
 }
 
 struct qtmir::MirServerHooks::Self
@@ -85,6 +103,8 @@ struct qtmir::MirServerHooks::Self
     std::weak_ptr<mir::shell::DisplayConfigurationController> m_mirDisplayConfigurationController;
     std::weak_ptr<mir::scene::PromptSessionManager> m_mirPromptSessionManager;
     std::weak_ptr<mir::input::InputDeviceHub> m_inputDeviceHub;
+    std::shared_ptr<ShellImageCursorWrapper> m_shellImageCursor;
+    std::shared_ptr<qtmir::HardwareCursor> m_hardwareCursor;
 };
 
 qtmir::MirServerHooks::MirServerHooks() :
@@ -94,11 +114,23 @@ qtmir::MirServerHooks::MirServerHooks() :
 
 void qtmir::MirServerHooks::operator()(mir::Server& server)
 {
-    server.override_the_cursor_images([]
-        { return std::make_shared<qtmir::MirCursorImages>(); });
-
-    server.wrap_cursor([&](std::shared_ptr<mg::Cursor> const& wrapped)
-        { return std::make_shared<HiddenCursorWrapper>(wrapped); });
+    if (HardwareCursor::isRequested()) {
+        // Mir loads the real cursor theme images, which HardwareCursor then shows
+        auto theme = qgetenv("XCURSOR_THEME");
+        miral::CursorTheme{theme.isEmpty() ? "default" : theme.toStdString()}(server);
+
+        server.wrap_cursor([this](std::shared_ptr<mg::Cursor> const& wrapped)
+            {
+                self->m_shellImageCursor = std::make_shared<ShellImageCursorWrapper>(wrapped);
+                return self->m_shellImageCursor;
+            });
+    } else {
+        server.override_the_cursor_images([]
+            { return std::make_shared<qtmir::MirCursorImages>(); });
+
+        server.wrap_cursor([&](std::shared_ptr<mg::Cursor> const& wrapped)
+            { return std::make_shared<HiddenCursorWrapper>(wrapped); });
+    }
 
     server.override_the_prompt_session_listener([this]
         {
@@ -113,6 +145,16 @@ void qtmir::MirServerHooks::operator()(mir::Server& server)
             self->m_mirDisplayConfigurationController = server.the_display_configuration_controller();
             self->m_mirPromptSessionManager = server.the_prompt_session_manager();
             self->m_inputDeviceHub = server.the_input_device_hub();
+
+            if (HardwareCursor::isRequested()) {
+                server.the_cursor(); // make sure the wrapper exists
+                if (self->m_shellImageCursor) {
+                    self->m_hardwareCursor = std::make_shared<HardwareCursor>(
+                        self->m_shellImageCursor->wrapped, server.the_cursor_images());
+                } else {
+                    qCWarning(QTMIR_MIR_INPUT) << "No Mir cursor to drive, falling back to the QML mouse pointer";
+                }
+            }
         });
 }
 
@@ -148,6 +190,11 @@ std::shared_ptr<mir::input::InputDeviceHub> qtmir::MirServerHooks::theInputDevic
     throw std::logic_error("No input device hub available. Server not running?");
 }
 
+qtmir::HardwareCursor *qtmir::MirServerHooks::hardwareCursor() const
+{
+    return self->m_hardwareCursor.get();
+}
+
 QSharedPointer<ScreensController> qtmir::MirServerHooks::createScreensController(QSharedPointer<ScreensModel> const &screensModel) const
 {
     return QSharedPointer<ScreensController>(
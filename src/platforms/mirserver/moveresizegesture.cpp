@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "moveresizegesture.h"
+
+#include <QtGlobal>
+
+using namespace qtmir;
+using namespace mir::geometry;
+
+namespace {
+
+Point touchPosition(const MirTouchEvent *event, size_t index)
+{
+    return Point{static_cast<int>(mir_touch_event_axis_value(event, index, mir_touch_axis_x)),
+                 static_cast<int>(mir_touch_event_axis_value(event, index, mir_touch_axis_y))};
+}
+
+Point pointerPosition(const MirPointerEvent *event)
+{
+    return Point{static_cast<int>(mir_pointer_event_axis_value(event, mir_pointer_axis_x)),
+                 static_cast<int>(mir_pointer_event_axis_value(event, mir_pointer_axis_y))};
+}
+
+} // anonymous namespace
+
+bool MoveResizeGesture::begin(const miral::Window &window, const Rectangle &geometry,
+                              const MirInputEvent *event, MirResizeEdge edge)
+{
+    switch (mir_input_event_get_type(event)) {
+    case mir_input_event_type_pointer:
+        m_startCursor = pointerPosition(mir_input_event_get_pointer_event(event));
+        break;
+    case mir_input_event_type_touch: {
+        const auto touchEvent = mir_input_event_get_touch_event(event);
+        const size_t count = mir_touch_event_point_count(touchEvent);
+        if (count < 1) {
+            return false;
+        }
+        // The touch that just went down is the one the client reacted to
+        size_t index = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (mir_touch_event_action(touchEvent, i) == mir_touch_action_down) {
+                index = i;
+                break;
+            }
+        }
+        m_touchId = mir_touch_event_id(touchEvent, index);
+        m_startCursor = touchPosition(touchEvent, index);
+        break;
+    }
+    default:
+        return false;
+    }
+
+    m_window = window;
+    m_edge = edge;
+    m_device = mir_input_event_get_type(event);
+    m_startGeometry = geometry;
+    return true;
+}
+
+void MoveResizeGesture::reset()
+{
+    *this = MoveResizeGesture();
+}
+
+MoveResizeGesture::Step MoveResizeGesture::follow(const MirInputEvent *event) const
+{
+    Step step;
+    if (!m_window || mir_input_event_get_type(event) != m_device) {
+        return step;
+    }
+
+    if (m_device == mir_input_event_type_pointer) {
+        const auto pointerEvent = mir_input_event_get_pointer_event(event);
+        step.moved = true;
+        step.cursor = pointerPosition(pointerEvent);
+        step.released = mir_pointer_event_buttons(pointerEvent) == 0;
+        return step;
+    }
+
+    // Touch events carry every touch that is down, so one missing ours means its release went amiss
+    const auto touchEvent = mir_input_event_get_touch_event(event);
+    step.released = true;
+    for (size_t i = 0, count = mir_touch_event_point_count(touchEvent); i < count; ++i) {
+        if (mir_touch_event_id(touchEvent, i) == m_touchId) {
+            step.moved = true;
+            step.cursor = touchPosition(touchEvent, i);
+            step.released = mir_touch_event_action(touchEvent, i) == mir_touch_action_up;
+            break;
+        }
+    }
+    return step;
+}
+
+Rectangle MoveResizeGesture::geometryAt(const Point cursor, const Size minSize, const Size maxSize) const
+{
+    const auto delta = cursor - m_startCursor;
+    const auto &start = m_startGeometry;
+
+    if (m_edge == mir_resize_edge_none) {
+        return Rectangle{start.top_left + delta, start.size};
+    }
+
+    const int edge = m_edge;
+    int left = start.top_left.x.as_int();
+    int top = start.top_left.y.as_int();
+    int width = start.size.width.as_int();
+    int height = start.size.height.as_int();
+
+    if (edge & mir_resize_edge_west) {
+        width -= delta.dx.as_int();
+    } else if (edge & mir_resize_edge_east) {
+        width += delta.dx.as_int();
+    }
+    if (edge & mir_resize_edge_north) {
+        height -= delta.dy.as_int();
+    } else if (edge & mir_resize_edge_south) {
+        height += delta.dy.as_int();
+    }
+
+    width = qBound(minSize.width.as_int(), width, maxSize.width.as_int());
+    height = qBound(minSize.height.as_int(), height, maxSize.height.as_int());
+
+    // Keep the opposite edge where it was
+    if (edge & mir_resize_edge_west) {
+        left += start.size.width.as_int() - width;
+    }
+    if (edge & mir_resize_edge_north) {
+        top += start.size.height.as_int() - height;
+    }
+
+    return Rectangle{Point{left, top}, Size{width, height}};
+}
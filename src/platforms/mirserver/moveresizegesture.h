@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QTMIR_MOVERESIZEGESTURE_H
+#define QTMIR_MOVERESIZEGESTURE_H
+
+#include <miral/window.h>
+
+#include <mir/geometry/rectangle.h>
+#include <mir_toolkit/event.h>
+
+namespace qtmir {
+
+/*
+  Client-requested move or resize (eg. dragging a client-side title bar), carried out by the window
+  manager so that it does not depend on the Qt GUI thread.
+
+  The gesture follows the pointer, or the touch point, that started it until that is released. Moves
+  follow the cursor; resizes keep the edge opposite to the one dragged in place and stay within the
+  window's size limits.
+
+  Only accessed with the WM lock held.
+ */
+class MoveResizeGesture
+{
+public:
+    // Returns false if event has no pointer or touch position to follow
+    bool begin(const miral::Window &window, const mir::geometry::Rectangle &geometry,
+               const MirInputEvent *event, MirResizeEdge edge);
+    void reset();
+
+    miral::Window window() const { return m_window; }
+    bool isResize() const { return m_edge != mir_resize_edge_none; }
+
+    struct Step {
+        bool moved{false};              // the gesture's pointer or touch point is now at cursor
+        mir::geometry::Point cursor;
+        bool released{false};           // and the gesture is over
+    };
+    Step follow(const MirInputEvent *event) const;
+
+    mir::geometry::Rectangle geometryAt(const mir::geometry::Point cursor,
+                                        const mir::geometry::Size minSize,
+                                        const mir::geometry::Size maxSize) const;
+
+private:
+    miral::Window m_window;
+    MirResizeEdge m_edge{mir_resize_edge_none}; // none for a move
+    MirInputEventType m_device{mir_input_event_type_pointer};
+    MirTouchId m_touchId{0};
+    mir::geometry::Point m_startCursor;
+    mir::geometry::Rectangle m_startGeometry;
+};
+
+} // namespace qtmir
+
+#endif // QTMIR_MOVERESIZEGESTURE_H
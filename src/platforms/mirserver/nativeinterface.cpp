@@ -110,6 +110,20 @@ void NativeInterface::setWindowProperty(QPlatformWindow */*window*/, const QStri
             qWarning().nospace() << "NativeInterface::setWindowProperty("
                 << name << "," << value << ") - value is not a QRect";
         }
+    } else if (name == QStringLiteral("directInputAllowed")) {
+        windowController->setDirectInputAllowed(value.toBool());
+    } else if (name == QStringLiteral("shellGestureRegions")) {
+        QVector<QRect> regions;
+        const QVariantList list = value.toList();
+        for (const QVariant &region : list) {
+            if (region.canConvert(QMetaType::QRect)) {
+                regions.append(region.toRect());
+            } else {
+                qWarning().nospace() << "NativeInterface::setWindowProperty("
+                    << name << "," << value << ") - value is not a list of QRect";
+            }
+        }
+        windowController->setShellGestureRegions(regions);
     }
 }
 
@@ -105,6 +105,8 @@ void *QMirServer::nativeResourceForIntegration(const QByteArray &resource) const
         result = d->windowModelNotifier();
     else if (resource == "ScreensController")
         result = d->screensController.data();
+    else if (resource == "HardwareCursor")
+        result = d->hardwareCursor();
 
     return result;
 }
@@ -20,7 +20,7 @@
 #include "logging.h"
 #include "timestamp.h"
 #include "tracepoints.h" // generated from tracepoints.tp
-#include "screen.h"
+#include "screensmodel.h"
 
 #include <qpa/qplatforminputcontext.h>
 #include <qpa/qplatformintegration.h>
@@ -379,7 +379,8 @@ namespace {
 class QtWindowSystem : public QtEventFeeder::QtWindowSystemInterface
 {
 public:
-    QtWindowSystem()
+    QtWindowSystem(const QSharedPointer<ScreensModel> &screensModel)
+        : m_screensModel(screensModel)
     {
         // because we're using QMetaObject::invoke with arguments of those types
         qRegisterMetaType<Qt::KeyboardModifiers>("Qt::KeyboardModifiers");
@@ -434,21 +435,22 @@ public:
     void handleMouseEvent(ulong timestamp, QPointF relative, QPointF absolute, Qt::MouseButtons buttons,
                           Qt::KeyboardModifiers modifiers) override
     {
-        // Send to the first screen that handles the mouse event
-        // TODO: Have a mechanism to tell which screen currently has the logical mouse pointer
-        //       (because they all might have their own separate graphical mouse pointer item)
-        //       This will probably come once we implement the feature of having the mouse pointer
-        //       crossing adjacent screens.
+        // Called from the Mir input thread, so QScreen is off limits
+        const auto screens = m_screensModel->screenGeometries();
+        const int pointerScreen = pointerScreenIndex(screens, absolute);
 
-        const QList<QScreen *> screens = qGuiApp->screens();
         bool eventHandled = false;
-        int i = 0;
-        while (i < screens.count() && !eventHandled) {
-            auto screenWindow = static_cast<Screen*>(screens[i]->handle());
-            auto platformCursor = static_cast<qtmir::Cursor*>(screenWindow->cursor());
-            eventHandled = platformCursor->handleMouseEvent(timestamp, relative, buttons, modifiers);
-            ++i;
+        if (pointerScreen != -1) {
+            eventHandled = screens[pointerScreen].cursor->handleMouseEvent(timestamp, relative, buttons, modifiers);
         }
+
+        // A shell might have a graphical mouse pointer on some other screen only
+        for (int i = 0; i < screens.count() && !eventHandled; ++i) {
+            if (i != pointerScreen) {
+                eventHandled = screens[i].cursor->handleMouseEvent(timestamp, relative, buttons, modifiers);
+            }
+        }
+
         if (!eventHandled) {
             QWindowSystemInterface::handleMouseEvent(focusedWindow(), timestamp, absolute, absolute, buttons, modifiers);
         }
@@ -456,32 +458,58 @@ public:
 
     void handleWheelEvent(ulong timestamp, QPointF absolute, QPoint angleDelta, Qt::KeyboardModifiers modifiers) override
     {
-        // Send to the first screen that handles the mouse event
-        // TODO: Have a mechanism to tell which screen currently has the logical mouse pointer
-        //       (because they all might have their own separate graphical mouse pointer item)
-        //       This will probably come once we implement the feature of having the mouse pointer
-        //       crossing adjacent screens.
+        const auto screens = m_screensModel->screenGeometries();
+        const int pointerScreen = pointerScreenIndex(screens, absolute);
 
-        const QList<QScreen *> screens = qGuiApp->screens();
         bool eventHandled = false;
-        int i = 0;
-        while (i < screens.count() && !eventHandled) {
-            auto screenWindow = static_cast<Screen*>(screens[i]->handle());
-            auto platformCursor = static_cast<qtmir::Cursor*>(screenWindow->cursor());
-            eventHandled = platformCursor->handleWheelEvent(timestamp, angleDelta, modifiers);
-            ++i;
+        if (pointerScreen != -1) {
+            eventHandled = screens[pointerScreen].cursor->handleWheelEvent(timestamp, angleDelta, modifiers);
         }
+
+        for (int i = 0; i < screens.count() && !eventHandled; ++i) {
+            if (i != pointerScreen) {
+                eventHandled = screens[i].cursor->handleWheelEvent(timestamp, angleDelta, modifiers);
+            }
+        }
+
         if (!eventHandled) {
             QWindowSystemInterface::handleWheelEvent(focusedWindow(), timestamp, absolute, absolute,
                                                      QPoint(), angleDelta, modifiers, Qt::ScrollUpdate);
         }
     }
+
+private:
+    // Returns the index of the screen the pointer is on. The answer only changes when the pointer crosses
+    // onto another screen, so usually a single geometry check against the last owner is enough.
+    int pointerScreenIndex(const QVector<ScreensModel::ScreenGeometry> &screens, const QPointF &absolute)
+    {
+        const QPoint point = absolute.toPoint();
+        if (m_pointerScreen < screens.count() && screens[m_pointerScreen].geometry.contains(point)) {
+            return m_pointerScreen;
+        }
+
+        for (int i = 0; i < screens.count(); ++i) {
+            if (screens[i].geometry.contains(point)) {
+                m_pointerScreen = i;
+                return i;
+            }
+        }
+
+        // Outside every screen (in a gap between outputs, say), so keep the last owner
+        if (m_pointerScreen >= screens.count()) {
+            m_pointerScreen = 0;
+        }
+        return screens.isEmpty() ? -1 : m_pointerScreen;
+    }
+
+    const QSharedPointer<ScreensModel> m_screensModel;
+    int m_pointerScreen{0};
 };
 
 } // anonymous namespace
 
-QtEventFeeder::QtEventFeeder()
-    : QtEventFeeder(new QtWindowSystem)
+QtEventFeeder::QtEventFeeder(const QSharedPointer<ScreensModel> &screensModel)
+    : QtEventFeeder(new QtWindowSystem(screensModel))
 {
 }
 
@@ -577,6 +605,9 @@ void QtEventFeeder::dispatchPointer(const MirPointerEvent *pev)
     auto timestamp = qtmir::compressTimestamp<qtmir::Timestamp>(
                 std::chrono::nanoseconds(mir_input_event_get_event_time(iev)));
     EventBuilder::instance()->store(iev, timestamp.count());
+
+    tracepoint(qtmirserver, inputEventDispatch_start, mir_input_event_type_pointer, mir_input_event_get_event_time(iev));
+
     auto action = mir_pointer_event_action(pev);
     qCDebug(QTMIR_MIR_INPUT) << "Received" << qPrintable(mirPointerEventToString(pev));
 
@@ -607,6 +638,8 @@ void QtEventFeeder::dispatchPointer(const MirPointerEvent *pev)
     default:
         qCDebug(QTMIR_MIR_INPUT) << "Unrecognized pointer event";
     }
+
+    tracepoint(qtmirserver, inputEventDispatch_end, mir_input_event_type_pointer, mir_input_event_get_event_time(iev));
 }
 
 void QtEventFeeder::dispatchKey(const MirKeyboardEvent *kev)
@@ -616,6 +649,8 @@ void QtEventFeeder::dispatchKey(const MirKeyboardEvent *kev)
                 std::chrono::nanoseconds(mir_input_event_get_event_time(iev)));
     EventBuilder::instance()->store(iev, timestamp.count());
 
+    tracepoint(qtmirserver, inputEventDispatch_start, mir_input_event_type_key, mir_input_event_get_event_time(iev));
+
     xkb_keysym_t xk_sym = mir_keyboard_event_key_code(kev);
 
     // Key modifier and unicode index mapping.
@@ -658,6 +693,8 @@ void QtEventFeeder::dispatchKey(const MirKeyboardEvent *kev)
         timestamp.count(), keyType, keyCode, modifiers,
         mir_keyboard_event_scan_code(kev), xk_sym,
         mir_keyboard_event_modifiers(kev), text, is_auto_rep);
+
+    tracepoint(qtmirserver, inputEventDispatch_end, mir_input_event_type_key, mir_input_event_get_event_time(iev));
 }
 
 void QtEventFeeder::dispatchTouch(const MirTouchEvent *tev)
@@ -667,7 +704,7 @@ void QtEventFeeder::dispatchTouch(const MirTouchEvent *tev)
                 std::chrono::nanoseconds(mir_input_event_get_event_time(iev)));
     EventBuilder::instance()->store(iev, timestamp.count());
 
-    tracepoint(qtmirserver, touchEventDispatch_start, std::chrono::nanoseconds(timestamp).count());
+    tracepoint(qtmirserver, inputEventDispatch_start, mir_input_event_type_touch, mir_input_event_get_event_time(iev));
 
     qCDebug(QTMIR_MIR_INPUT) << "Received" << qPrintable(mirTouchEventToString(tev));
 
@@ -676,6 +713,7 @@ void QtEventFeeder::dispatchTouch(const MirTouchEvent *tev)
     const float kMaxPressure = 1.28;
     const int kPointerCount = mir_touch_event_point_count(tev);
     QList<QWindowSystemInterface::TouchPoint> touchPoints;
+    touchPoints.reserve(kPointerCount);
     QWindow *window = nullptr;
 
     if (kPointerCount > 0) {
@@ -685,6 +723,7 @@ void QtEventFeeder::dispatchTouch(const MirTouchEvent *tev)
 
         if (!window) {
             qCDebug(QTMIR_MIR_INPUT) << "REJECTING INPUT EVENT, no matching window";
+            tracepoint(qtmirserver, inputEventDispatch_end, mir_input_event_type_touch, mir_input_event_get_event_time(iev));
             return;
         }
 
@@ -736,13 +775,13 @@ void QtEventFeeder::dispatchTouch(const MirTouchEvent *tev)
         mTouchDevice,
         touchPoints);
 
-    tracepoint(qtmirserver, touchEventDispatch_end, std::chrono::nanoseconds(timestamp).count());
+    tracepoint(qtmirserver, inputEventDispatch_end, mir_input_event_type_touch, mir_input_event_get_event_time(iev));
 }
 
 void QtEventFeeder::validateTouches(QWindow *window, ulong timestamp,
         QList<QWindowSystemInterface::TouchPoint> &touchPoints)
 {
-    QSet<int> updatedTouches;
+    QVarLengthArray<int, MaxInlineTouches> updatedTouches;
 
     {
         int i = 0;
@@ -751,47 +790,57 @@ void QtEventFeeder::validateTouches(QWindow *window, ulong timestamp,
             if (mustDiscardTouch) {
                 touchPoints.removeAt(i);
             } else {
-                updatedTouches.insert(touchPoints.at(i).id);
+                updatedTouches.append(touchPoints.at(i).id);
                 ++i;
             }
         }
     }
 
     // Release all unmentioned touches, one by one.
-    QHash<int, QWindowSystemInterface::TouchPoint>::iterator it = mActiveTouches.begin();
-    while (it != mActiveTouches.end()) {
-        if (!updatedTouches.contains(it.key())) {
-            qCWarning(QTMIR_MIR_INPUT)
-                << "There's a touch (id =" << it.key() << ") missing. Releasing it.";
-            sendActiveTouchRelease(window, timestamp, it.key());
-            it = mActiveTouches.erase(it);
-        } else {
-            ++it;
+    {
+        int i = 0;
+        while (i < mActiveTouches.count()) {
+            const int id = mActiveTouches.at(i).id;
+            if (!updatedTouches.contains(id)) {
+                qCWarning(QTMIR_MIR_INPUT)
+                    << "There's a touch (id =" << id << ") missing. Releasing it.";
+                sendActiveTouchRelease(window, timestamp, id);
+                mActiveTouches.remove(i);
+            } else {
+                ++i;
+            }
         }
     }
 
     // update mActiveTouches
     for (int i = 0; i < touchPoints.count(); ++i) {
         auto &touchPoint = touchPoints.at(i);
+        const int index = indexOfActiveTouch(touchPoint.id);
         if (touchPoint.state == Qt::TouchPointReleased) {
-            mActiveTouches.remove(touchPoint.id);
+            if (index != -1) {
+                mActiveTouches.remove(index);
+            }
+        } else if (index != -1) {
+            mActiveTouches[index] = touchPoint;
         } else {
-            mActiveTouches[touchPoint.id] = touchPoint;
+            mActiveTouches.append(touchPoint);
         }
     }
 }
 
 void QtEventFeeder::sendActiveTouchRelease(QWindow *window, ulong timestamp, int id)
 {
-    QList<QWindowSystemInterface::TouchPoint> touchPoints = mActiveTouches.values();
+    QList<QWindowSystemInterface::TouchPoint> touchPoints;
+    touchPoints.reserve(mActiveTouches.count());
 
-    for (int i = 0; i < touchPoints.count(); ++i) {
-        QWindowSystemInterface::TouchPoint &touchPoint = touchPoints[i];
+    for (int i = 0; i < mActiveTouches.count(); ++i) {
+        QWindowSystemInterface::TouchPoint touchPoint = mActiveTouches.at(i);
         if (touchPoint.id == id) {
             touchPoint.state = Qt::TouchPointReleased;
         } else {
             touchPoint.state = Qt::TouchPointStationary;
         }
+        touchPoints.append(touchPoint);
     }
 
     qCDebug(QTMIR_MIR_INPUT) << "Sending to Qt" << qPrintable(touchesToString(touchPoints));
@@ -801,10 +850,11 @@ void QtEventFeeder::sendActiveTouchRelease(QWindow *window, ulong timestamp, int
 bool QtEventFeeder::validateTouch(QWindowSystemInterface::TouchPoint &touchPoint)
 {
     bool ok = true;
+    const bool isActive = indexOfActiveTouch(touchPoint.id) != -1;
 
     switch (touchPoint.state) {
     case Qt::TouchPointPressed:
-        if (mActiveTouches.contains(touchPoint.id)) {
+        if (isActive) {
             qCWarning(QTMIR_MIR_INPUT)
                 << "Would press an already existing touch (id =" << touchPoint.id
                 << "). Making it move instead.";
@@ -812,7 +862,7 @@ bool QtEventFeeder::validateTouch(QWindowSystemInterface::TouchPoint &touchPoint
         }
         break;
     case Qt::TouchPointMoved:
-        if (!mActiveTouches.contains(touchPoint.id)) {
+        if (!isActive) {
             qCWarning(QTMIR_MIR_INPUT)
                 << "Would move a touch that wasn't pressed before (id =" << touchPoint.id
                 << "). Making it press instead.";
@@ -820,7 +870,7 @@ bool QtEventFeeder::validateTouch(QWindowSystemInterface::TouchPoint &touchPoint
         }
         break;
     case Qt::TouchPointStationary:
-        if (!mActiveTouches.contains(touchPoint.id)) {
+        if (!isActive) {
             qCWarning(QTMIR_MIR_INPUT)
                 << "There's an stationary touch that wasn't pressed before (id =" << touchPoint.id
                 << "). Making it press instead.";
@@ -828,7 +878,7 @@ bool QtEventFeeder::validateTouch(QWindowSystemInterface::TouchPoint &touchPoint
         }
         break;
     case Qt::TouchPointReleased:
-        if (!mActiveTouches.contains(touchPoint.id)) {
+        if (!isActive) {
             qCWarning(QTMIR_MIR_INPUT)
                 << "Would release a touch that wasn't pressed before (id =" << touchPoint.id
                 << "). Ignoring it.";
@@ -842,6 +892,16 @@ bool QtEventFeeder::validateTouch(QWindowSystemInterface::TouchPoint &touchPoint
     return ok;
 }
 
+int QtEventFeeder::indexOfActiveTouch(int id) const
+{
+    for (int i = 0; i < mActiveTouches.count(); ++i) {
+        if (mActiveTouches.at(i).id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 QString QtEventFeeder::touchesToString(const QList<struct QWindowSystemInterface::TouchPoint> &points)
 {
     QString result;
@@ -21,7 +21,11 @@
 
 #include <qpa/qwindowsysteminterface.h>
 
+#include <QSharedPointer>
+#include <QVarLengthArray>
+
 class QTouchDevice;
+class ScreensModel;
 
 /*
   Fills Qt's event loop with input events from Mir
@@ -53,7 +57,7 @@ public:
                                       Qt::KeyboardModifiers modifiers) = 0;
     };
 
-    QtEventFeeder();
+    explicit QtEventFeeder(const QSharedPointer<ScreensModel> &screensModel);
     QtEventFeeder(QtWindowSystemInterface *windowSystem);
     virtual ~QtEventFeeder();
 
@@ -68,13 +72,17 @@ private:
     bool validateTouch(QWindowSystemInterface::TouchPoint &touchPoint);
     void sendActiveTouchRelease(QWindow *window, ulong timestamp, int id);
 
+    int indexOfActiveTouch(int id) const;
+
     QString touchesToString(const QList<struct QWindowSystemInterface::TouchPoint> &points);
 
     QTouchDevice *mTouchDevice;
     QtWindowSystemInterface *mQtWindowSystem;
 
-    // Maps the id of an active touch to its last known state
-    QHash<int, QWindowSystemInterface::TouchPoint> mActiveTouches;
+    // Last known state of each active touch. Touch screens rarely report more than 10 simultaneous
+    // touches, so keep them inline to avoid any heap allocation on the touch dispatch path.
+    enum { MaxInlineTouches = 10 };
+    QVarLengthArray<QWindowSystemInterface::TouchPoint, MaxInlineTouches> mActiveTouches;
 };
 
 #endif // MIR_QT_EVENT_FEEDER_H
@@ -153,7 +153,15 @@ Screen::Screen(const mir::graphics::DisplayConfigurationOutput &screen,
     , m_renderTarget(nullptr)
     , m_displayGroup(nullptr)
     , m_screenWindow(nullptr)
+    // The Mir input thread may hold on to it for a little while after this screen is gone
+    , m_cursor(new qtmir::Cursor, &QObject::deleteLater)
 {
+    // Screens get created from the Mir server thread too, which has no event loop to run the
+    // cursor's queued calls or its deleteLater
+    if (QCoreApplication::instance()) {
+        m_cursor->moveToThread(QCoreApplication::instance()->thread());
+    }
+
     // Hack to make signals work
     this->moveToThread(orientationSensor->thread());
 
@@ -315,9 +323,6 @@ void Screen::onOrientationReadingChanged(QOrientationReading::Orientation orient
 
 QPlatformCursor *Screen::cursor() const
 {
-    if (!m_cursor) {
-        const_cast<Screen*>(this)->m_cursor.reset(new qtmir::Cursor);
-    }
     return m_cursor.data();
 }
 
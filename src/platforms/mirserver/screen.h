@@ -19,7 +19,7 @@
 
 // Qt
 #include <QObject>
-#include <QScopedPointer>
+#include <QSharedPointer>
 #include <QTimer>
 #include <qpa/qplatformscreen.h>
 #include <QtSensors/QOrientationReading>
@@ -112,7 +112,7 @@ private:
 
     ScreenWindow *m_screenWindow;
 
-    QScopedPointer<qtmir::Cursor> m_cursor;
+    QSharedPointer<qtmir::Cursor> m_cursor; // shared with the Mir input thread, see ScreensModel
 
     friend class ScreensModel;
     friend class ScreenWindow;
@@ -153,6 +153,9 @@ void ScreensModel::update()
         }
     );
 
+    // Stop pointing the input thread at Screens about to be deleted
+    updateScreenGeometries();
+
     // Announce new Screens to Qt
     Q_FOREACH (auto screen, newScreenList) {
         Q_EMIT screenAdded(screen);
@@ -212,6 +215,24 @@ void ScreensModel::update()
     qCDebug(QTMIR_SCREENS) << "=======================================";
 }
 
+QVector<ScreensModel::ScreenGeometry> ScreensModel::screenGeometries() const
+{
+    QMutexLocker locker(&m_screenGeometriesMutex);
+    return m_screenGeometries;
+}
+
+void ScreensModel::updateScreenGeometries()
+{
+    QVector<ScreenGeometry> screenGeometries;
+    screenGeometries.reserve(m_screenList.count());
+    Q_FOREACH (auto screen, m_screenList) {
+        screenGeometries.append(ScreenGeometry{screen->geometry(), screen->m_cursor});
+    }
+
+    QMutexLocker locker(&m_screenGeometriesMutex);
+    m_screenGeometries = screenGeometries;
+}
+
 bool ScreensModel::canUpdateExistingScreen(const Screen *screen, const mg::DisplayConfigurationOutput &output)
 {
     // Compare the properties of the existing Screen with its new configuration. Properties
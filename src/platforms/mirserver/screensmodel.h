@@ -17,8 +17,12 @@
 #ifndef SCREENCONTROLLER_H
 #define SCREENCONTROLLER_H
 
+#include <QMutex>
 #include <QObject>
 #include <QPoint>
+#include <QRect>
+#include <QSharedPointer>
+#include <QVector>
 
 // Mir
 #include "mir/int_wrapper.h"
@@ -41,6 +45,7 @@ namespace mir {
 class Screen;
 class QtCompositor;
 class OrientationSensor;
+namespace qtmir { class Cursor; }
 /*
  * ScreensModel monitors the Mir display configuration and compositor status, and updates
  * the relevant QScreen and QWindow states accordingly.
@@ -58,7 +63,7 @@ class OrientationSensor;
  * Mir has initialized but before Qt's event loop has started, and tear down before Mir terminates.
  * Also note the MirServerThread does not have an QEventLoop.
  *
- * All other methods must be called on the Qt GUI thread.
+ * All other methods must be called on the Qt GUI thread, except for screenGeometries().
  */
 
 class ScreensModel : public QObject
@@ -70,6 +75,14 @@ public:
     QList<Screen*> screens() const { return m_screenList; }
     bool compositing() const { return m_compositing; }
 
+    // Where the screens are, and their cursors, as of the last update(). Can be called from any thread:
+    // it is how the Mir input thread finds the screen under the pointer without touching QScreen.
+    struct ScreenGeometry {
+        QRect geometry;
+        QSharedPointer<qtmir::Cursor> cursor;
+    };
+    QVector<ScreenGeometry> screenGeometries() const;
+
 Q_SIGNALS:
     void screenAdded(Screen *screen);
     void screenRemoved(Screen *screen);
@@ -97,6 +110,7 @@ private:
     bool canUpdateExistingScreen(const Screen *screen, const mir::graphics::DisplayConfigurationOutput &output);
     void startRenderer();
     void haltRenderer();
+    void updateScreenGeometries();
 
     std::weak_ptr<mir::graphics::Display> m_display;
     std::shared_ptr<QtCompositor> m_compositor;
@@ -104,6 +118,9 @@ private:
     QList<Screen*> m_screenList;
     bool m_compositing;
     std::shared_ptr<OrientationSensor> m_orientationSensor;
+
+    mutable QMutex m_screenGeometriesMutex;
+    QVector<ScreenGeometry> m_screenGeometries; // replaced as a whole, so copies can be read lock-free
 };
 
 #endif // SCREENCONTROLLER_H
@@ -18,8 +18,9 @@
 #include "logging.h"
 #include "tracepoints.h" // generated from tracepoints.tp
 
+#include <QElapsedTimer>
 #include <QMetaMethod>
-#include <QThread>
+#include <QMutexLocker>
 
 SessionAuthorizer::SessionAuthorizer(QObject *parent)
     : QObject(parent)
@@ -31,6 +32,14 @@ SessionAuthorizer::~SessionAuthorizer()
 {
 }
 
+void SessionAuthorizer::connectNotify(const QMetaMethod &signal)
+{
+    if (signal == QMetaMethod::fromSignal(&SessionAuthorizer::requestAuthorizationForSession)) {
+        QMutexLocker locker(&m_listenerMutex);
+        m_listenerConnected.wakeAll();
+    }
+}
+
 bool SessionAuthorizer::connection_is_allowed(miral::ApplicationCredentials const& creds)
 {
     tracepoint(qtmirserver, sessionAuthorizeStart);
@@ -39,9 +48,14 @@ bool SessionAuthorizer::connection_is_allowed(miral::ApplicationCredentials cons
 
     if (!m_connectionChecked) {
         // Wait until the ApplicationManager is ready to receive requestAuthorizationForSession signals
-        QMetaMethod mm = QMetaMethod::fromSignal(&SessionAuthorizer::requestAuthorizationForSession);
-        for (int i = 0; i < 100 && !isSignalConnected(mm); ++i) {
-            QThread::usleep(10000);
+        const QMetaMethod mm = QMetaMethod::fromSignal(&SessionAuthorizer::requestAuthorizationForSession);
+        const int timeout = 1000; // ms
+
+        QMutexLocker locker(&m_listenerMutex);
+        QElapsedTimer waited;
+        waited.start();
+        while (!isSignalConnected(mm) && waited.elapsed() < timeout) {
+            m_listenerConnected.wait(&m_listenerMutex, timeout - waited.elapsed());
         }
         if (!isSignalConnected(mm)) {
             qCDebug(QTMIR_MIR_MESSAGES) <<
@@ -18,13 +18,16 @@
 #define SESSIONAUTHORIZER_H
 
 //std
+#include <atomic>
 #include <string>
 
 // mir
 #include <miral/application_authorizer.h>
 
 // Qt
+#include <QMutex>
 #include <QObject>
+#include <QWaitCondition>
 
 class SessionAuthorizer : public QObject, public miral::ApplicationAuthorizer
 {
@@ -43,11 +46,16 @@ public:
     bool set_base_input_configuration_is_allowed(miral::ApplicationCredentials const& creds) override;
 
 Q_SIGNALS:
-    // needs to be blocked queued signal which returns value for authorized
+    // needs a direct connection, as it returns the value for authorized. It is emitted from Mir IPC threads
     void requestAuthorizationForSession(const pid_t &pid, bool &authorized);
 
+protected:
+    void connectNotify(const QMetaMethod &signal) override;
+
 private:
-    bool m_connectionChecked;
+    std::atomic<bool> m_connectionChecked;
+    QMutex m_listenerMutex;
+    QWaitCondition m_listenerConnected;
 };
 
 #endif // SESSIONAUTHORIZER_H
@@ -17,8 +17,7 @@
 #include "surfaceobserver.h"
 
 #include <QHash>
-#include <QMutexLocker>
-#include <QMutex>
+#include <QReadWriteLock>
 
 #include <miral/window_specification.h>
 #include <mir/geometry/size.h>
@@ -38,70 +37,124 @@ QRect calculateBoundingRect(const std::vector<mir::geometry::Rectangle> &rectVec
     return boundingRect;
 }
 
-QHash<const mir::scene::Surface*, SurfaceObserver*> surfaceToObserverMap;
-QMutex mutex;
+// Sharded, so that lookups from Mir threads seldom wait on each other or on (un)registration
+// from the Qt GUI thread.
+class ObserverRegistry
+{
+public:
+    struct Shard {
+        QReadWriteLock lock;
+        QHash<const mir::scene::Surface*, SurfaceObserver*> observers;
+    };
+
+    Shard &shardFor(const mir::scene::Surface *surface)
+    {
+        // Surfaces are heap allocated, so the low bits of their address are always the same. Fibonacci
+        // hashing spreads the rest over the shards, taking the top bits of the product.
+        const quint64 hash = quint64(quintptr(surface) >> 4) * Q_UINT64_C(0x9E3779B97F4A7C15);
+        return m_shards[hash >> (64 - shardBits)];
+    }
+
+private:
+    static const int shardBits = 4;
+    static const int shardCount = 1 << shardBits;
+    Shard m_shards[shardCount];
+};
+
+ObserverRegistry registry;
 } // anonymous namespace
 
 
 SurfaceObserver::~SurfaceObserver()
 {
-    QMutexLocker locker(&mutex);
-    QMutableHashIterator<const mir::scene::Surface*, SurfaceObserver*> i(surfaceToObserverMap);
-    while (i.hasNext()) {
-        i.next();
-        if (i.value() == this) {
-            i.remove();
+    if (!m_registeredSurface) {
+        return;
+    }
+
+    auto &shard = registry.shardFor(m_registeredSurface);
+    QWriteLocker locker(&shard.lock);
+    auto it = shard.observers.find(m_registeredSurface);
+    if (it != shard.observers.end() && it.value() == this) {
+        shard.observers.erase(it);
+    }
+}
+
+void SurfaceObserverChanges::setAttribute(MirWindowAttrib attribute, int value)
+{
+    for (auto &change : attributes) {
+        if (change.first == attribute) {
+            change.second = value;
             return;
         }
     }
+    attributes.append(qMakePair(attribute, value));
 }
 
 void SurfaceObserver::notifySurfaceModifications(const miral::WindowSpecification &modifications)
 {
-    if (modifications.min_width().is_set()) {
-        Q_EMIT minimumWidthChanged(modifications.min_width().value().as_int());
-    }
-    if (modifications.min_height().is_set()) {
-        Q_EMIT minimumHeightChanged(modifications.min_height().value().as_int());
-    }
-    if (modifications.max_width().is_set()) {
-        Q_EMIT maximumWidthChanged(modifications.max_width().value().as_int());
-    }
-    if (modifications.max_height().is_set()) {
-        Q_EMIT maximumHeightChanged(modifications.max_height().value().as_int());
-    }
-    if (modifications.width_inc().is_set()) {
-        Q_EMIT widthIncrementChanged(modifications.width_inc().value().as_int());
-    }
-    if (modifications.height_inc().is_set()) {
-        Q_EMIT heightIncrementChanged(modifications.height_inc().value().as_int());
-    }
-    if (modifications.shell_chrome().is_set()) {
-        Q_EMIT shellChromeChanged(modifications.shell_chrome().value());
-    }
-    if (modifications.input_shape().is_set()) {
-        QRect qRect = calculateBoundingRect(modifications.input_shape().value());
-        Q_EMIT inputBoundsChanged(qRect);
-    }
-    if (modifications.confine_pointer().is_set()) {
-        Q_EMIT confinesMousePointerChanged(modifications.confine_pointer().value() == mir_pointer_confined_to_window);
-    }
-    if (modifications.name().is_set()) {
-        Q_EMIT nameChanged(QString::fromStdString(modifications.name().value()));
-    }
+    recordChange([&modifications](SurfaceObserverChanges &changes) {
+        if (modifications.min_width().is_set()) {
+            changes.minimumWidth = modifications.min_width().value().as_int();
+            changes.fields |= SurfaceObserverChanges::MinimumWidth;
+        }
+        if (modifications.min_height().is_set()) {
+            changes.minimumHeight = modifications.min_height().value().as_int();
+            changes.fields |= SurfaceObserverChanges::MinimumHeight;
+        }
+        if (modifications.max_width().is_set()) {
+            changes.maximumWidth = modifications.max_width().value().as_int();
+            changes.fields |= SurfaceObserverChanges::MaximumWidth;
+        }
+        if (modifications.max_height().is_set()) {
+            changes.maximumHeight = modifications.max_height().value().as_int();
+            changes.fields |= SurfaceObserverChanges::MaximumHeight;
+        }
+        if (modifications.width_inc().is_set()) {
+            changes.widthIncrement = modifications.width_inc().value().as_int();
+            changes.fields |= SurfaceObserverChanges::WidthIncrement;
+        }
+        if (modifications.height_inc().is_set()) {
+            changes.heightIncrement = modifications.height_inc().value().as_int();
+            changes.fields |= SurfaceObserverChanges::HeightIncrement;
+        }
+        if (modifications.shell_chrome().is_set()) {
+            changes.shellChrome = modifications.shell_chrome().value();
+            changes.fields |= SurfaceObserverChanges::ShellChrome;
+        }
+        if (modifications.input_shape().is_set()) {
+            changes.inputBounds = calculateBoundingRect(modifications.input_shape().value());
+            changes.fields |= SurfaceObserverChanges::InputBounds;
+        }
+        if (modifications.confine_pointer().is_set()) {
+            changes.confinesMousePointer = modifications.confine_pointer().value() == mir_pointer_confined_to_window;
+            changes.fields |= SurfaceObserverChanges::ConfinesMousePointer;
+        }
+        if (modifications.name().is_set()) {
+            changes.name = QString::fromStdString(modifications.name().value());
+            changes.fields |= SurfaceObserverChanges::Name;
+        }
+    });
+}
+
+SurfaceObserverChanges SurfaceObserver::takeChanges()
+{
+    QMutexLocker locker(&m_changesMutex);
+    SurfaceObserverChanges changes;
+    std::swap(changes, m_changes);
+    return changes;
 }
 
 SurfaceObserver *SurfaceObserver::observerForSurface(const mir::scene::Surface *surface)
 {
-    if (surfaceToObserverMap.contains(surface)) {
-        return surfaceToObserverMap.value(surface);
-    } else {
-        return nullptr;
-    }
+    auto &shard = registry.shardFor(surface);
+    QReadLocker locker(&shard.lock);
+    return shard.observers.value(surface, nullptr);
 }
 
 void SurfaceObserver::registerObserverForSurface(SurfaceObserver *observer, const mir::scene::Surface *surface)
 {
-    QMutexLocker locker(&mutex);
-    surfaceToObserverMap[surface] = observer;
+    auto &shard = registry.shardFor(surface);
+    QWriteLocker locker(&shard.lock);
+    shard.observers[surface] = observer;
+    observer->m_registeredSurface = surface; // so it can find its own entry again when destroyed
 }
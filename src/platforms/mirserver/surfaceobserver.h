@@ -17,9 +17,14 @@
 #ifndef SESSIONOBSERVER_H
 #define SESSIONOBSERVER_H
 
+#include <QCursor>
+#include <QMutex>
 #include <QObject>
+#include <QPair>
 #include <QRect>
 #include <QSize>
+#include <QString>
+#include <QVector>
 
 #include <mir_toolkit/common.h>
 #include <mir/geometry/size.h>
@@ -33,6 +38,43 @@ namespace mir {
 
 namespace miral { class WindowSpecification; }
 
+// Surface changes observed since the Qt side last collected them. Only the latest value of each is kept.
+struct SurfaceObserverChanges
+{
+    enum Field {
+        Name                 = 1 << 0,
+        Cursor               = 1 << 1,
+        Hidden               = 1 << 2,
+        MinimumWidth         = 1 << 3,
+        MinimumHeight        = 1 << 4,
+        MaximumWidth         = 1 << 5,
+        MaximumHeight        = 1 << 6,
+        WidthIncrement       = 1 << 7,
+        HeightIncrement      = 1 << 8,
+        ShellChrome          = 1 << 9,
+        InputBounds          = 1 << 10,
+        ConfinesMousePointer = 1 << 11
+    };
+
+    bool isEmpty() const { return fields == 0 && attributes.isEmpty(); }
+    void setAttribute(MirWindowAttrib attribute, int value);
+
+    uint fields{0};
+    QVector<QPair<MirWindowAttrib, int>> attributes; // in the order they first changed
+    QString name;
+    QCursor cursor;
+    bool hidden{false};
+    int minimumWidth{0};
+    int minimumHeight{0};
+    int maximumWidth{0};
+    int maximumHeight{0};
+    int widthIncrement{0};
+    int heightIncrement{0};
+    MirShellChrome shellChrome{mir_shell_chrome_normal};
+    QRect inputBounds;
+    bool confinesMousePointer{false};
+};
+
 class SurfaceObserver : public QObject
 {
     Q_OBJECT
@@ -48,26 +90,40 @@ public:
 
     void notifySurfaceModifications(const miral::WindowSpecification&);
 
+    // Hands over, and forgets, the changes observed so far. Called from the Qt GUI thread.
+    SurfaceObserverChanges takeChanges();
+
     static SurfaceObserver *observerForSurface(const mir::scene::Surface *surface);
     static void registerObserverForSurface(SurfaceObserver *observer, const mir::scene::Surface *surface);
 
 Q_SIGNALS:
-    void attributeChanged(const MirWindowAttrib attribute, const int value);
     void framesPosted();
     void resized(const QSize &size);
-    void nameChanged(const QString &name);
-    void cursorChanged(const QCursor &cursor);
-    void hiddenChanged(const bool hide);
-
-    void minimumWidthChanged(int);
-    void minimumHeightChanged(int);
-    void maximumWidthChanged(int);
-    void maximumHeightChanged(int);
-    void widthIncrementChanged(int);
-    void heightIncrementChanged(int);
-    void shellChromeChanged(MirShellChrome);
-    void inputBoundsChanged(const QRect &rect);
-    void confinesMousePointerChanged(bool);
+
+    // Emitted, from whichever thread observed it, on the first change after the last takeChanges()
+    void changesPending();
+
+protected:
+    // Records a change from any thread, where change is callable with a SurfaceObserverChanges&
+    template<typename Change>
+    void recordChange(Change change)
+    {
+        bool wasEmpty;
+        {
+            QMutexLocker locker(&m_changesMutex);
+            wasEmpty = m_changes.isEmpty();
+            change(m_changes);
+        }
+        if (wasEmpty) {
+            Q_EMIT changesPending();
+        }
+    }
+
+private:
+    QMutex m_changesMutex;
+    SurfaceObserverChanges m_changes;
+
+    const mir::scene::Surface *m_registeredSurface{nullptr};
 };
 
 #endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "touchrouter.h"
+
+#include <QMutexLocker>
+
+using namespace qtmir;
+
+void TouchRouter::setDirectInputWindow(const miral::Window &window, bool enabled)
+{
+    QMutexLocker locker(&m_directInputMutex);
+    if (enabled) {
+        m_directInput.window = window;
+    } else if (m_directInput.window == window) {
+        // Focus may already have moved on to another direct input window
+        m_directInput.window = miral::Window();
+    }
+}
+
+void TouchRouter::setDirectInputAllowed(bool allowed)
+{
+    QMutexLocker locker(&m_directInputMutex);
+    m_directInput.allowed = allowed;
+}
+
+void TouchRouter::setShellGestureRegions(const QVector<QRect> &regions)
+{
+    QMutexLocker locker(&m_directInputMutex);
+    m_directInput.shellGestureRegions = regions;
+}
+
+miral::Window TouchRouter::route(const MirTouchEvent *event)
+{
+    const int pointCount = mir_touch_event_point_count(event);
+
+    bool sequenceStarts = m_route == Route::Undecided && pointCount > 0;
+    bool sequenceEnds = true;
+    for (int i = 0; i < pointCount; ++i) {
+        const auto action = mir_touch_event_action(event, i);
+        sequenceStarts &= action == mir_touch_action_down;
+        sequenceEnds &= action == mir_touch_action_up;
+    }
+
+    if (sequenceStarts) {
+        QMutexLocker locker(&m_directInputMutex);
+        m_route = Route::Qt;
+        if (m_directInput.allowed && m_directInput.window) {
+            m_route = Route::Direct;
+            for (int i = 0; i < pointCount && m_route == Route::Direct; ++i) {
+                const QPoint point(mir_touch_event_axis_value(event, i, mir_touch_axis_x),
+                                   mir_touch_event_axis_value(event, i, mir_touch_axis_y));
+                for (const QRect &region : m_directInput.shellGestureRegions) {
+                    if (region.contains(point)) {
+                        m_route = Route::Qt;
+                        break;
+                    }
+                }
+            }
+            m_directTouchWindow = m_directInput.window;
+        }
+    }
+
+    const miral::Window window = m_route == Route::Direct ? m_directTouchWindow : miral::Window();
+
+    if (sequenceEnds) {
+        m_route = Route::Undecided;
+        m_directTouchWindow = miral::Window();
+    }
+
+    return window;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QTMIR_TOUCHROUTER_H
+#define QTMIR_TOUCHROUTER_H
+
+#include <miral/window.h>
+
+#include <mir_toolkit/event.h>
+
+#include <QMutex>
+#include <QRect>
+#include <QVector>
+
+namespace qtmir {
+
+/*
+  Decides whether touches skip the Qt scene and go straight to the direct input window.
+
+  Touch sequences are routed as a whole, when their first touch goes down: directly if the shell
+  allows it, there is a direct input window and none of the touches starts inside a shell gesture
+  region (eg. screen edges), through Qt otherwise. So neither side ever sees half a sequence.
+
+  Qt GUI thread configures it, Mir input thread routes events.
+ */
+class TouchRouter
+{
+public:
+    void setDirectInputWindow(const miral::Window &window, bool enabled);
+    void setDirectInputAllowed(bool allowed);
+    void setShellGestureRegions(const QVector<QRect> &regions);
+
+    // Returns the window the event has to be delivered to directly, or a null window if it goes through Qt
+    miral::Window route(const MirTouchEvent *event);
+
+private:
+    struct DirectInput {
+        miral::Window window;
+        bool allowed{false};
+        QVector<QRect> shellGestureRegions;
+    } m_directInput;
+    QMutex m_directInputMutex;
+
+    // Only accessed from the Mir input thread
+    enum class Route { Undecided, Qt, Direct };
+    Route m_route{Route::Undecided};
+    miral::Window m_directTouchWindow;
+};
+
+} // namespace qtmir
+
+#endif // QTMIR_TOUCHROUTER_H
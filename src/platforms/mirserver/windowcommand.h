@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QTMIR_WINDOWCOMMAND_H
+#define QTMIR_WINDOWCOMMAND_H
+
+#include <miral/window.h>
+
+#include <QPoint>
+#include <QSize>
+#include <QVector>
+
+#include <stdexcept>
+
+// Unity API
+#include <unity/shell/application/Mir.h>
+
+namespace qtmir {
+
+/*
+ * A change to the window stack requested by the shell. WindowController queues these up over a
+ * GUI thread event loop iteration and WindowManagementPolicy applies them under one WM lock.
+ */
+struct WindowCommand
+{
+    enum Type {
+        Activate,
+        Raise,
+        Resize,
+        Move,
+        RequestState,
+        RequestClose,
+        ForceClose
+    };
+
+    Type type;
+    miral::Window window;
+    QSize size;                             // Resize
+    QPoint topLeft;                         // Move
+    Mir::State state{Mir::UnknownState};    // RequestState
+
+    bool applied{false};                    // false if the window was gone by the time it was applied
+};
+
+/*
+ * Applies each command in turn with applyOne, which throws std::out_of_range if the command's
+ * window is gone. Such a command is left marked as not applied and the rest still go ahead.
+ */
+template<typename ApplyOne>
+void applyWindowCommands(QVector<WindowCommand> &commands, ApplyOne applyOne)
+{
+    for (auto &command : commands) {
+        try {
+            applyOne(command);
+            command.applied = true;
+        } catch (const std::out_of_range&) {
+            // usually shell trying to operate on a window which already closed, just ignore
+            // (throws from tools.info_for(...) usually)
+            // TODO: MirSurface extends the miral::Window lifetime by holding a shared pointer to
+            // the mir::scene::Surface, meaning it cannot detect when the window has been closed
+            // and thus avoid queueing commands for it.
+        }
+    }
+}
+
+} // namespace qtmir
+
+#endif // QTMIR_WINDOWCOMMAND_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "windowcommandqueue.h"
+
+using namespace qtmir;
+
+WindowCommandQueue::WindowCommandQueue(const Apply &apply)
+    : m_apply(apply)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    QObject::connect(&m_flushTimer, &QTimer::timeout, [this]() { flush(); });
+}
+
+void WindowCommandQueue::enqueue(WindowCommand &&command)
+{
+    m_pendingCommands.append(std::move(command));
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void WindowCommandQueue::flush()
+{
+    if (m_pendingCommands.isEmpty()) {
+        return;
+    }
+
+    m_flushTimer.stop();
+    QVector<WindowCommand> commands;
+    commands.swap(m_pendingCommands);
+
+    m_apply(commands);
+
+    if (m_resultHandler) {
+        for (const auto &command : commands) {
+            m_resultHandler(command);
+        }
+    }
+}
+
+void WindowCommandQueue::setResultHandler(const ResultHandler &handler)
+{
+    m_resultHandler = handler;
+}
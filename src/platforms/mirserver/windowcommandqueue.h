@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QTMIR_WINDOWCOMMANDQUEUE_H
+#define QTMIR_WINDOWCOMMANDQUEUE_H
+
+#include "windowcommand.h"
+
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+namespace qtmir {
+
+/*
+ * Queues up window commands issued from the GUI thread and hands them over in one batch, once the
+ * GUI thread gets back to its event loop or when flushed explicitly. Commands are applied in the
+ * order they were queued.
+ */
+class WindowCommandQueue
+{
+public:
+    using Apply = std::function<void(QVector<WindowCommand> &commands)>;
+    using ResultHandler = std::function<void(const WindowCommand &command)>;
+
+    explicit WindowCommandQueue(const Apply &apply);
+
+    void enqueue(WindowCommand &&command);
+
+    // Applies the commands queued so far, if any
+    void flush();
+
+    // Told about every command once its batch has been applied, see WindowCommand::applied
+    void setResultHandler(const ResultHandler &handler);
+
+    bool isEmpty() const { return m_pendingCommands.isEmpty(); }
+
+private:
+    const Apply m_apply;
+    ResultHandler m_resultHandler;
+    QVector<WindowCommand> m_pendingCommands;
+    QTimer m_flushTimer;
+};
+
+} // namespace qtmir
+
+#endif // QTMIR_WINDOWCOMMANDQUEUE_H
@@ -17,6 +17,7 @@
 #include "windowcontroller.h"
 
 #include "windowmanagementpolicy.h"
+#include "logging.h"
 #include "mirqtconversion.h"
 
 using namespace qtmir;
@@ -24,60 +25,64 @@ using namespace qtmir;
 
 WindowController::WindowController()
     : m_policy(nullptr)
+    , m_commands([this](QVector<WindowCommand> &commands) {
+        if (m_policy) {
+            m_policy->apply(commands);
+        }
+    })
 {
+    m_commands.setResultHandler([](const WindowCommand &command) {
+        if (!command.applied) {
+            qCDebug(QTMIR_SURFACES) << "WindowController: window gone before command" << command.type
+                                    << "could be applied";
+        }
+    });
 }
 
 void WindowController::activate(const miral::Window &window)
 {
-    if (m_policy) {
-        m_policy->activate(window);
-    }
+    enqueue({WindowCommand::Activate, window, {}, {}, Mir::UnknownState});
 }
 
 void WindowController::raise(const miral::Window &window)
 {
-    if (m_policy) {
-        m_policy->raise(window);
-    }
+    enqueue({WindowCommand::Raise, window, {}, {}, Mir::UnknownState});
 }
 
 void WindowController::resize(const miral::Window &window, const QSize &size)
 {
-    if (m_policy) {
-        m_policy->resize(window, toMirSize(size));
-    }
+    enqueue({WindowCommand::Resize, window, size, {}, Mir::UnknownState});
 }
 
 void WindowController::move(const miral::Window &window, const QPoint &topLeft)
 {
-    if (m_policy) {
-        m_policy->move(window, toMirPoint(topLeft));
-    }
+    enqueue({WindowCommand::Move, window, {}, topLeft, Mir::UnknownState});
 }
 
+// Closing is not put off, but still follows any command issued before it
+
 void WindowController::requestClose(const miral::Window &window)
 {
-    if (m_policy) {
-        m_policy->ask_client_to_close(window);
-    }
+    enqueue({WindowCommand::RequestClose, window, {}, {}, Mir::UnknownState});
+    flush();
 }
 
 void WindowController::forceClose(const miral::Window &window)
 {
-    if (m_policy) {
-        m_policy->forceClose(window);
-    }
+    enqueue({WindowCommand::ForceClose, window, {}, {}, Mir::UnknownState});
+    flush();
 }
 
 void WindowController::requestState(const miral::Window &window, const Mir::State state)
 {
-    if (m_policy) {
-        m_policy->requestState(window, state);
-    }
+    enqueue({WindowCommand::RequestState, window, {}, {}, state});
 }
 
+// Input may depend on queued window changes (eg. activating the window it's for), so apply those first
+
 void WindowController::deliverKeyboardEvent(const miral::Window &window, const MirKeyboardEvent *event)
 {
+    flush();
     if (m_policy) {
         m_policy->deliver_keyboard_event(event, window);
     }
@@ -85,6 +90,7 @@ void WindowController::deliverKeyboardEvent(const miral::Window &window, const M
 
 void WindowController::deliverTouchEvent(const miral::Window &window, const MirTouchEvent *event)
 {
+    flush();
     if (m_policy) {
         m_policy->deliver_touch_event(event, window);
     }
@@ -92,6 +98,7 @@ void WindowController::deliverTouchEvent(const miral::Window &window, const MirT
 
 void WindowController::deliverPointerEvent(const miral::Window &window, const MirPointerEvent *event)
 {
+    flush();
     if (m_policy) {
         m_policy->deliver_pointer_event(event, window);
     }
@@ -111,7 +118,42 @@ void WindowController::setWindowMargins(Mir::Type windowType, const QMargins &ma
     }
 }
 
+void WindowController::setDirectInputWindow(const miral::Window &window, bool enabled)
+{
+    if (m_policy) {
+        m_policy->set_direct_input_window(window, enabled);
+    }
+}
+
+void WindowController::setDirectInputAllowed(bool allowed)
+{
+    if (m_policy) {
+        m_policy->set_direct_input_allowed(allowed);
+    }
+}
+
+void WindowController::setShellGestureRegions(const QVector<QRect> &regions)
+{
+    if (m_policy) {
+        m_policy->set_shell_gesture_regions(regions);
+    }
+}
+
 void WindowController::setPolicy(WindowManagementPolicy * const policy)
 {
     m_policy = policy;
 }
+
+void WindowController::enqueue(WindowCommand &&command)
+{
+    if (m_policy) {
+        m_commands.enqueue(std::move(command));
+    }
+}
+
+void WindowController::flush()
+{
+    if (m_policy) {
+        m_commands.flush();
+    }
+}
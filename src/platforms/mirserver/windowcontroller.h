@@ -17,6 +17,7 @@
 #ifndef WINDOWCONTROLLER_H
 #define WINDOWCONTROLLER_H
 
+#include "windowcommandqueue.h"
 #include "windowcontrollerinterface.h"
 
 class WindowManagementPolicy;
@@ -46,10 +47,23 @@ public:
     void setWindowConfinementRegions(const QVector<QRect> &regions) override;
     void setWindowMargins(Mir::Type windowType, const QMargins &margins) override;
 
+    void setDirectInputWindow(const miral::Window &window, bool enabled) override;
+    void setDirectInputAllowed(bool allowed) override;
+    void setShellGestureRegions(const QVector<QRect> &regions) override;
+
     void setPolicy(WindowManagementPolicy *policy);
 
+    // Applies the window commands queued so far
+    void flush();
+
 protected:
+    void enqueue(WindowCommand &&command);
+
     WindowManagementPolicy *m_policy;
+
+    // activate, raise, resize, move and requestState are queued up and applied together once
+    // the GUI thread gets back to its event loop, rather than each taking the WM lock
+    WindowCommandQueue m_commands;
 };
 
 } // namespace qtmir
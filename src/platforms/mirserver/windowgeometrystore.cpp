@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "windowgeometrystore.h"
+#include "logging.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSettings>
+#include <QStandardPaths>
+
+#include <functional>
+
+namespace {
+// Applications not seen for a while make way for new ones past this point
+const int maxEntries = 256;
+
+class SaveTask : public QRunnable
+{
+public:
+    explicit SaveTask(const std::function<void()> &save) : m_save(save) {}
+    void run() override { m_save(); }
+
+private:
+    const std::function<void()> m_save;
+};
+}
+
+QHash<pid_t, QString> WindowGeometryStore::appIdForPid;
+QHash<WindowGeometryStore::Key, WindowGeometryStore::Entry> WindowGeometryStore::entries;
+quint64 WindowGeometryStore::useCounter = 0;
+bool WindowGeometryStore::loaded = false;
+bool WindowGeometryStore::dirty = false;
+QMutex WindowGeometryStore::mutex;
+QThreadPool WindowGeometryStore::saveThread;
+
+void WindowGeometryStore::setAppId(pid_t pid, const QString &appId)
+{
+    QMutexLocker locker(&mutex);
+
+    // First use is normally from here, on the Qt GUI thread, rather than from the window manager
+    ensureLoaded();
+    appIdForPid[pid] = appId;
+}
+
+void WindowGeometryStore::removeAppId(pid_t pid)
+{
+    QMutexLocker locker(&mutex);
+
+    appIdForPid.remove(pid);
+}
+
+void WindowGeometryStore::record(pid_t pid, const QString &windowName, const Geometry &geometry)
+{
+    QMutexLocker locker(&mutex);
+
+    auto appId = appIdForPid.constFind(pid);
+    if (appId == appIdForPid.constEnd()) {
+        return;
+    }
+    ensureLoaded();
+
+    auto it = entries.find(Key(appId.value(), windowName));
+    if (it == entries.end()) {
+        if (!geometry.isValid()) {
+            return;
+        }
+        if (entries.count() >= maxEntries) {
+            auto oldest = entries.begin();
+            for (auto candidate = entries.begin(); candidate != entries.end(); ++candidate) {
+                if (candidate->lastUsed < oldest->lastUsed) {
+                    oldest = candidate;
+                }
+            }
+            entries.erase(oldest);
+        }
+        it = entries.insert(Key(appId.value(), windowName), Entry{geometry, 0});
+    } else {
+        it->geometry.state = geometry.state;
+        // Keep the last known restored size if the window has none to tell
+        if (geometry.isValid()) {
+            it->geometry.size = geometry.size;
+        }
+    }
+    it->lastUsed = ++useCounter;
+    dirty = true;
+}
+
+WindowGeometryStore::Geometry WindowGeometryStore::find(pid_t pid, const QString &windowName)
+{
+    QMutexLocker locker(&mutex);
+
+    auto appId = appIdForPid.constFind(pid);
+    if (appId == appIdForPid.constEnd()) {
+        return Geometry();
+    }
+    ensureLoaded();
+
+    auto it = entries.constFind(Key(appId.value(), windowName));
+    if (it == entries.constEnd()) {
+        return Geometry();
+    }
+    return it->geometry;
+}
+
+void WindowGeometryStore::load()
+{
+    // Let any save in progress finish, so that what is loaded is what was last saved
+    saveThread.waitForDone();
+
+    QMutexLocker locker(&mutex);
+
+    loaded = false;
+    ensureLoaded();
+}
+
+void WindowGeometryStore::save()
+{
+    QHash<Key, Entry> entriesToSave;
+    {
+        QMutexLocker locker(&mutex);
+
+        if (!dirty) {
+            return;
+        }
+        entriesToSave = entries; // implicitly shared, only copied once either side changes it
+        dirty = false;
+    }
+
+    // Saves happen one at a time, in order, away from the caller's thread
+    saveThread.setMaxThreadCount(1);
+    saveThread.start(new SaveTask([entriesToSave]() {
+        if (!write(entriesToSave)) {
+            QMutexLocker locker(&mutex);
+            dirty = true; // try again next time
+        }
+    }));
+}
+
+bool WindowGeometryStore::write(const QHash<Key, Entry> &entriesToSave)
+{
+    QSettings settings(filePath(), QSettings::IniFormat);
+    settings.remove(QStringLiteral("windows"));
+    settings.beginWriteArray(QStringLiteral("windows"), entriesToSave.count());
+    int i = 0;
+    for (auto it = entriesToSave.constBegin(); it != entriesToSave.constEnd(); ++it, ++i) {
+        settings.setArrayIndex(i);
+        settings.setValue(QStringLiteral("appId"), it.key().first);
+        settings.setValue(QStringLiteral("name"), it.key().second);
+        settings.setValue(QStringLiteral("size"), it->geometry.size);
+        settings.setValue(QStringLiteral("state"), static_cast<int>(it->geometry.state));
+        settings.setValue(QStringLiteral("lastUsed"), it->lastUsed);
+    }
+    settings.endArray();
+    settings.sync();
+
+    if (settings.status() != QSettings::NoError) {
+        qCWarning(QTMIR_SURFACES) << "WindowGeometryStore: failed to save to" << settings.fileName();
+        return false;
+    }
+    return true;
+}
+
+void WindowGeometryStore::ensureLoaded()
+{
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    dirty = false;
+    entries.clear();
+    useCounter = 0;
+
+    QSettings settings(filePath(), QSettings::IniFormat);
+    const int count = settings.beginReadArray(QStringLiteral("windows"));
+    for (int i = 0; i < count; ++i) {
+        settings.setArrayIndex(i);
+        Entry entry;
+        entry.geometry.size = settings.value(QStringLiteral("size")).toSize();
+        entry.geometry.state = static_cast<Mir::State>(settings.value(QStringLiteral("state")).toInt());
+        entry.lastUsed = settings.value(QStringLiteral("lastUsed")).toULongLong();
+        if (!entry.geometry.isValid()) {
+            continue;
+        }
+        entries.insert(Key(settings.value(QStringLiteral("appId")).toString(),
+                           settings.value(QStringLiteral("name")).toString()), entry);
+        useCounter = qMax(useCounter, entry.lastUsed);
+    }
+    settings.endArray();
+}
+
+QString WindowGeometryStore::filePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+            + QStringLiteral("/qtmir/windowgeometry.ini");
+}
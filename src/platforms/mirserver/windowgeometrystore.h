@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WINDOWGEOMETRYSTORE_H
+#define WINDOWGEOMETRYSTORE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+#include <unity/shell/application/Mir.h>
+
+#include <sys/types.h>
+
+/*
+  The last known size and state of top-level windows, keyed by application id and window name,
+  kept across sessions so that a relaunched application gets its window at its final size straight away.
+
+  Qt GUI thread saves it to disk, from a thread of its own, and is told which application each pid
+  belongs to when the session is authorized. mir/miral thread records windows as they go away and
+  queries it when placing new ones.
+ */
+class WindowGeometryStore
+{
+public:
+    struct Geometry {
+        bool isValid() const { return size.isValid(); }
+
+        QSize size; // of the window when last restored, invalid if not known
+        Mir::State state{Mir::UnknownState};
+    };
+
+    static void setAppId(pid_t, const QString &appId);
+    static void removeAppId(pid_t);
+
+    static void record(pid_t, const QString &windowName, const Geometry &);
+    static Geometry find(pid_t, const QString &windowName);
+
+    // Replaces what is in memory with what was last saved
+    static void load();
+    // Writes to disk in the background, if anything changed since the last load or save
+    static void save();
+
+private:
+    using Key = QPair<QString, QString>; // application id, window name
+    struct Entry {
+        Geometry geometry;
+        quint64 lastUsed;
+    };
+
+    static void ensureLoaded();
+    static bool write(const QHash<Key, Entry> &entries);
+    static QString filePath();
+
+    static QHash<pid_t, QString> appIdForPid;
+    static QHash<Key, Entry> entries;
+    static quint64 useCounter;
+    static bool loaded;
+    static bool dirty;
+    static QMutex mutex;
+    static QThreadPool saveThread;
+};
+
+#endif // WINDOWGEOMETRYSTORE_H
@@ -20,10 +20,13 @@
 #include "initialsurfacesizes.h"
 #include "screensmodel.h"
 #include "surfaceobserver.h"
+#include "windowgeometrystore.h"
 
 #include "miral/window_manager_tools.h"
 #include "miral/window_specification.h"
 
+#include <mir/events/event_builders.h>
+
 #include "mirqtconversion.h"
 #include "tracepoints.h"
 
@@ -44,11 +47,16 @@ WindowManagementPolicy::WindowManagementPolicy(const miral::WindowManagerTools &
     , m_windowModel(windowModel)
     , m_appNotifier(appNotifier)
     , m_screensModel(screensModel)
+    , m_eventFeeder(screensModel)
 {
     qRegisterMetaType<qtmir::NewWindow>();
     qRegisterMetaType<std::vector<miral::Window>>();
     qRegisterMetaType<miral::ApplicationInfo>();
     windowController.setPolicy(this);
+
+    if (qEnvironmentVariableIsSet("QTMIR_INPUT_TRACE")) {
+        m_inputTrace.reset(new qtmir::InputTraceWriter(QString::fromLocal8Bit(qgetenv("QTMIR_INPUT_TRACE"))));
+    }
 }
 
 /* Following are hooks to allow custom policy be imposed */
@@ -62,14 +70,35 @@ miral::WindowSpecification WindowManagementPolicy::place_new_window(
 
         int surfaceType = requestParameters.type().is_set() ? requestParameters.type().value() : -1;
 
-        QSize initialSize = InitialSurfaceSizes::get(miral::pid_of(appInfo.application()));
-
-        if (initialSize.isValid() && surfaceType == mir_window_type_normal) {
-            parameters.size() = toMirSize(initialSize);
-        }
+        const pid_t pid = miral::pid_of(appInfo.application());
+        QSize initialSize = InitialSurfaceSizes::get(pid);
 
         auto surfaceName = requestParameters.name().is_set() ? requestParameters.name().value() : "";
 
+        if (surfaceType == mir_window_type_normal) {
+            // Create it as the shell last left it, instead of resizing it once it has drawn its first frame
+            auto lastGeometry = WindowGeometryStore::find(pid, QString::fromStdString(surfaceName));
+
+            if (initialSize.isValid()) {
+                parameters.size() = toMirSize(initialSize);
+            } else if (lastGeometry.isValid()) {
+                parameters.size() = toMirSize(lastGeometry.size);
+            }
+
+            switch (lastGeometry.state) {
+            case Mir::MaximizedState:
+            case Mir::VertMaximizedState:
+            case Mir::HorizMaximizedState:
+            case Mir::FullscreenState:
+                if (!requestParameters.state().is_set()) {
+                    parameters.state() = toMirState(lastGeometry.state);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
         if (surfaceName == "maliit-server") {
             parameters.type() = mir_window_type_inputmethod;
         }
@@ -82,7 +111,7 @@ miral::WindowSpecification WindowManagementPolicy::place_new_window(
 
 void WindowManagementPolicy::handle_window_ready(miral::WindowInfo &windowInfo)
 {
-    Q_EMIT m_windowModel.windowReady(windowInfo);
+    m_windowModel.notifyWindowReady(windowInfo);
 
     auto appInfo = tools.info_for(windowInfo.window().application());
     Q_EMIT m_appNotifier.appCreatedWindow(appInfo);
@@ -113,7 +142,7 @@ void WindowManagementPolicy::handle_modify_window(
 
 void WindowManagementPolicy::handle_raise_window(miral::WindowInfo &windowInfo)
 {
-    Q_EMIT m_windowModel.windowRequestedRaise(windowInfo);
+    m_windowModel.notifyWindowRequestedRaise(windowInfo);
 }
 
 Rectangle WindowManagementPolicy::confirm_placement_on_display(const miral::WindowInfo &/*window_info*/,
@@ -126,18 +155,41 @@ Rectangle WindowManagementPolicy::confirm_placement_on_display(const miral::Wind
 /* Handle input events - here just inject them into Qt event loop for later processing */
 bool WindowManagementPolicy::handle_keyboard_event(const MirKeyboardEvent *event)
 {
+    tracepoint(qtmirserver, inputEventArrived, mir_input_event_type_key,
+               mir_input_event_get_event_time(mir_keyboard_event_input_event(event)));
+    if (m_inputTrace) {
+        m_inputTrace->record(mir_keyboard_event_input_event(event));
+    }
     m_eventFeeder.dispatchKey(event);
     return true;
 }
 
 bool WindowManagementPolicy::handle_touch_event(const MirTouchEvent *event)
 {
-    m_eventFeeder.dispatchTouch(event);
+    tracepoint(qtmirserver, inputEventArrived, mir_input_event_type_touch,
+               mir_input_event_get_event_time(mir_touch_event_input_event(event)));
+    if (m_inputTrace) {
+        m_inputTrace->record(mir_touch_event_input_event(event));
+    }
+    if (m_moveResize.window()) {
+        followMoveResize(mir_touch_event_input_event(event));
+    }
+    if (!deliverTouchDirectly(event)) {
+        m_eventFeeder.dispatchTouch(event);
+    }
     return true;
 }
 
 bool WindowManagementPolicy::handle_pointer_event(const MirPointerEvent *event)
 {
+    tracepoint(qtmirserver, inputEventArrived, mir_input_event_type_pointer,
+               mir_input_event_get_event_time(mir_pointer_event_input_event(event)));
+    if (m_inputTrace) {
+        m_inputTrace->record(mir_pointer_event_input_event(event));
+    }
+    if (m_moveResize.window()) {
+        followMoveResize(mir_pointer_event_input_event(event));
+    }
     m_eventFeeder.dispatchPointer(event);
     return true;
 }
@@ -151,17 +203,34 @@ void WindowManagementPolicy::advise_new_window(const miral::WindowInfo &windowIn
     // FIXME: remove when possible
     getExtraInfo(windowInfo)->state = toQtState(windowInfo.state());
 
-    Q_EMIT m_windowModel.windowAdded(NewWindow{windowInfo});
+    m_windowModel.notifyWindowAdded(NewWindow{windowInfo});
 }
 
 void WindowManagementPolicy::advise_delete_window(const miral::WindowInfo &windowInfo)
 {
-    Q_EMIT m_windowModel.windowRemoved(windowInfo);
+    if (m_moveResize.window() == windowInfo.window()) {
+        m_moveResize.reset();
+    }
+
+    if (windowInfo.type() == mir_window_type_normal && !windowInfo.parent()) {
+        WindowGeometryStore::Geometry geometry;
+        geometry.state = getExtraInfo(windowInfo)->state;
+        if (windowInfo.state() == mir_window_state_restored) {
+            geometry.size = toQSize(windowInfo.window().size());
+        } else if (windowInfo.restore_rect().size != Size{}) {
+            // What it would go back to, rather than its maximized, fullscreen, etc size
+            geometry.size = toQSize(windowInfo.restore_rect().size);
+        }
+        WindowGeometryStore::record(miral::pid_of(windowInfo.window().application()),
+                                    QString::fromStdString(windowInfo.name()), geometry);
+    }
+
+    m_windowModel.notifyWindowRemoved(windowInfo);
 }
 
 void WindowManagementPolicy::advise_raise(const std::vector<miral::Window> &windows)
 {
-    Q_EMIT m_windowModel.windowsRaised(windows);
+    m_windowModel.notifyWindowsRaised(windows);
 }
 
 void WindowManagementPolicy::advise_new_app(miral::ApplicationInfo &application)
@@ -189,40 +258,45 @@ void WindowManagementPolicy::advise_state_change(const miral::WindowInfo &window
         extraWinInfo->state = toQtState(state);
     }
 
-    Q_EMIT m_windowModel.windowStateChanged(windowInfo, extraWinInfo->state);
+    m_windowModel.notifyWindowStateChanged(windowInfo, extraWinInfo->state);
 }
 
 void WindowManagementPolicy::advise_move_to(const miral::WindowInfo &windowInfo, Point topLeft)
 {
-    Q_EMIT m_windowModel.windowMoved(windowInfo, toQPoint(topLeft));
+    m_windowModel.notifyWindowMoved(windowInfo, toQPoint(topLeft));
 }
 
 void WindowManagementPolicy::advise_resize(const miral::WindowInfo &windowInfo, const Size &newSize)
 {
-    Q_EMIT m_windowModel.windowResized(windowInfo, toQSize(newSize));
+    m_windowModel.notifyWindowResized(windowInfo, toQSize(newSize));
 }
 
 void WindowManagementPolicy::advise_focus_lost(const miral::WindowInfo &windowInfo)
 {
-    Q_EMIT m_windowModel.windowFocusChanged(windowInfo, false);
+    const mir::scene::Surface *surface = std::shared_ptr<mir::scene::Surface>(windowInfo.window()).get();
+    m_activeSurface.compare_exchange_strong(surface, nullptr);
+
+    m_windowModel.notifyWindowFocusChanged(windowInfo, false);
 }
 
 void WindowManagementPolicy::advise_focus_gained(const miral::WindowInfo &windowInfo)
 {
+    m_activeSurface = std::shared_ptr<mir::scene::Surface>(windowInfo.window()).get();
+
     // update Qt model ASAP, before applying Mir policy
-    Q_EMIT m_windowModel.windowFocusChanged(windowInfo, true);
+    m_windowModel.notifyWindowFocusChanged(windowInfo, true);
 
     CanonicalWindowManagerPolicy::advise_focus_gained(windowInfo);
 }
 
 void WindowManagementPolicy::advise_begin()
 {
-    Q_EMIT m_windowModel.modificationsStarted();
+    m_windowModel.beginChanges();
 }
 
 void WindowManagementPolicy::advise_end()
 {
-    Q_EMIT m_windowModel.modificationsEnded();
+    m_windowModel.endChanges();
 }
 
 void WindowManagementPolicy::advise_output_create(miral::Output const& output)
@@ -246,6 +320,11 @@ void WindowManagementPolicy::advise_output_delete(miral::Output const& output)
 
 void WindowManagementPolicy::ensureWindowIsActive(const miral::Window &window)
 {
+    // Called for every touch, so avoid contending for the WM lock unless focus has to change
+    if (m_activeSurface == std::shared_ptr<mir::scene::Surface>(window).get()) {
+        return;
+    }
+
     tools.invoke_under_lock([&window, this]() {
         if (tools.active_window() != window) {
             tools.select_active_window(window);
@@ -266,6 +345,36 @@ QRect WindowManagementPolicy::getConfinementRect(const QRect rect) const
     return confinementRect;
 }
 
+/*
+    Bypasses the Qt scene for touches on a focused fullscreen window, saving the round trip through
+    the Qt event loop and the MirEvent reconstruction in MirSurface.
+
+    TouchRouter decides which touch sequences qualify.
+ */
+bool WindowManagementPolicy::deliverTouchDirectly(const MirTouchEvent *event)
+{
+    const miral::Window window = m_touchRouter.route(event);
+    if (!window) {
+        return false;
+    }
+
+    tracepoint(qtmirserver, inputEventDeliver, mir_input_event_type_touch,
+               mir_input_event_get_event_time(mir_touch_event_input_event(event)));
+
+    // Mir surfaces consume events in surface-local coordinates
+    const auto topLeft = window.top_left();
+    if (topLeft == Point{0, 0}) {
+        dispatchInputEvent(window, mir_touch_event_input_event(event));
+    } else {
+        auto e = reinterpret_cast<MirEvent const*>(mir_touch_event_input_event(event)); // naughty
+        auto localEvent = mir::events::clone_event(*e);
+        mir::events::transform_positions(*localEvent, topLeft - Point{0, 0});
+        dispatchInputEvent(window, mir_event_get_input_event(localEvent.get()));
+    }
+
+    return true;
+}
+
 /* Following methods all called from the Qt GUI thread to deliver events to clients */
 void WindowManagementPolicy::deliver_keyboard_event(const MirKeyboardEvent *event,
                                                     const miral::Window &window)
@@ -274,6 +383,8 @@ void WindowManagementPolicy::deliver_keyboard_event(const MirKeyboardEvent *even
         ensureWindowIsActive(window);
     }
 
+    tracepoint(qtmirserver, inputEventDeliver, mir_input_event_type_key,
+               mir_input_event_get_event_time(mir_keyboard_event_input_event(event)));
     dispatchInputEvent(window, mir_keyboard_event_input_event(event));
 }
 
@@ -282,6 +393,8 @@ void WindowManagementPolicy::deliver_touch_event(const MirTouchEvent *event,
 {
     ensureWindowIsActive(window);
 
+    tracepoint(qtmirserver, inputEventDeliver, mir_input_event_type_touch,
+               mir_input_event_get_event_time(mir_touch_event_input_event(event)));
     dispatchInputEvent(window, mir_touch_event_input_event(event));
 }
 
@@ -293,86 +406,66 @@ void WindowManagementPolicy::deliver_pointer_event(const MirPointerEvent *event,
         ensureWindowIsActive(window);
     }
 
+    tracepoint(qtmirserver, inputEventDeliver, mir_input_event_type_pointer,
+               mir_input_event_get_event_time(mir_pointer_event_input_event(event)));
     dispatchInputEvent(window, mir_pointer_event_input_event(event));
 }
 
 /* Methods to allow Shell to request changes to the window stack. Called from the Qt GUI thread */
 
-// raises the window tree and focus it.
-void WindowManagementPolicy::activate(const miral::Window &window)
-{
-    try {
-        if (window) {
-            auto &windowInfo = tools.info_for(window);
-
-            // restore from minimized if needed
-            if (windowInfo.state() == mir_window_state_minimized) {
-                auto extraInfo = getExtraInfo(windowInfo);
-                Q_ASSERT(extraInfo->previousState != Mir::MinimizedState);
-                requestState(window, extraInfo->previousState);
+// Applies the commands in order, in a single WM transaction
+void WindowManagementPolicy::apply(QVector<WindowCommand> &commands)
+{
+    tools.invoke_under_lock([&commands, this]() {
+        applyWindowCommands(commands, [this](const WindowCommand &command) {
+            switch (command.type) {
+            case WindowCommand::Activate:
+                activate(command.window);
+                break;
+            case WindowCommand::Raise:
+                tools.raise_tree(command.window);
+                break;
+            case WindowCommand::Resize: {
+                miral::WindowSpecification modifications;
+                modifications.size() = toMirSize(command.size);
+                tools.modify_window(tools.info_for(command.window), modifications);
+                break;
+            }
+            case WindowCommand::Move: {
+                miral::WindowSpecification modifications;
+                modifications.top_left() = toMirPoint(command.topLeft);
+                tools.modify_window(tools.info_for(command.window), modifications);
+                break;
+            }
+            case WindowCommand::RequestState:
+                requestState(command.window, command.state);
+                break;
+            case WindowCommand::RequestClose:
+                tools.ask_client_to_close(command.window);
+                break;
+            case WindowCommand::ForceClose:
+                tools.force_close(command.window);
+                break;
             }
-        }
-
-        tools.invoke_under_lock([&]() {
-            tools.select_active_window(window);
         });
-    } catch (const std::out_of_range&) {
-        // usually shell trying to operate on a window which already closed, just ignore
-        // (throws from tools.info_for(...) ususally)
-        // TODO: Same issue as resize below
-    }
-}
-
-// raises the window tree
-void WindowManagementPolicy::raise(const miral::Window &window)
-{
-    tools.invoke_under_lock([&window, this]() {
-        tools.raise_tree(window);
     });
 }
 
-void WindowManagementPolicy::resize(const miral::Window &window, const Size size)
+// raises the window tree and focus it. WM lock must be held.
+void WindowManagementPolicy::activate(const miral::Window &window)
 {
-    miral::WindowSpecification modifications;
-    modifications.size() = size;
-    tools.invoke_under_lock([&window, &modifications, this]() {
-        try {
-            tools.modify_window(tools.info_for(window), modifications);
-        } catch (const std::out_of_range&) {
-            // usually shell trying to operate on a window which already closed, just ignore
-            // TODO: MirSurface extends the miral::Window lifetime by holding a shared pointer to
-            // the mir::scene::Surface, meaning it cannot detect when the window has been closed
-            // and thus avoid calling this method.
-        }
-    });
-}
+    if (window) {
+        auto &windowInfo = tools.info_for(window);
 
-void WindowManagementPolicy::move(const miral::Window &window, const Point topLeft)
-{
-    miral::WindowSpecification modifications;
-    modifications.top_left() = topLeft;
-    tools.invoke_under_lock([&window, &modifications, this]() {
-        try {
-            tools.modify_window(tools.info_for(window), modifications);
-        } catch (const std::out_of_range&) {
-            // usually shell trying to operate on a window which already closed, just ignore
-            // TODO: see above comment in resize, same issue
+        // restore from minimized if needed
+        if (windowInfo.state() == mir_window_state_minimized) {
+            auto extraInfo = getExtraInfo(windowInfo);
+            Q_ASSERT(extraInfo->previousState != Mir::MinimizedState);
+            requestState(window, extraInfo->previousState);
         }
-    });
-}
-
-void WindowManagementPolicy::ask_client_to_close(const miral::Window &window)
-{
-    tools.invoke_under_lock([&window, this]() {
-        tools.ask_client_to_close(window);
-    });
-}
+    }
 
-void WindowManagementPolicy::forceClose(const miral::Window &window)
-{
-    tools.invoke_under_lock([&window, this]() {
-        tools.force_close(window);
-    });
+    tools.select_active_window(window);
 }
 
 void WindowManagementPolicy::set_window_confinement_regions(const QVector<QRect> &regions)
@@ -389,6 +482,22 @@ void WindowManagementPolicy::set_window_margins(MirWindowType windowType, const
     // TODO: update window positions/sizes to respect new margins.
 }
 
+void WindowManagementPolicy::set_direct_input_window(const miral::Window &window, bool enabled)
+{
+    m_touchRouter.setDirectInputWindow(window, enabled);
+}
+
+void WindowManagementPolicy::set_direct_input_allowed(bool allowed)
+{
+    m_touchRouter.setDirectInputAllowed(allowed);
+}
+
+void WindowManagementPolicy::set_shell_gesture_regions(const QVector<QRect> &regions)
+{
+    m_touchRouter.setShellGestureRegions(regions);
+}
+
+// WM lock must be held
 void WindowManagementPolicy::requestState(const miral::Window &window, const Mir::State state)
 {
     auto &windowInfo = tools.info_for(window);
@@ -406,11 +515,9 @@ void WindowManagementPolicy::requestState(const miral::Window &window, const Mir
     extraWinInfo->state = state;
 
     if (modifications.state() == windowInfo.state()) {
-        Q_EMIT m_windowModel.windowStateChanged(windowInfo, state);
+        m_windowModel.notifyWindowStateChanged(windowInfo, state);
     } else {
-        tools.invoke_under_lock([&]() {
-            tools.modify_window(windowInfo, modifications);
-        });
+        tools.modify_window(windowInfo, modifications);
     }
 }
 
@@ -466,14 +573,67 @@ void WindowManagementPolicy::handle_request_drag_and_drop(miral::WindowInfo &/*w
 
 }
 
-void WindowManagementPolicy::handle_request_move(miral::WindowInfo &/*window_info*/,
-                                                 const MirInputEvent */*input_event*/)
+void WindowManagementPolicy::handle_request_move(miral::WindowInfo &window_info,
+                                                 const MirInputEvent *input_event)
 {
+    beginMoveResize(window_info, input_event, mir_resize_edge_none);
+}
 
+void WindowManagementPolicy::handle_request_resize(miral::WindowInfo &window_info,
+                                                   const MirInputEvent *input_event, MirResizeEdge edge)
+{
+    if (edge != mir_resize_edge_none) {
+        beginMoveResize(window_info, input_event, edge);
+    }
 }
 
-void WindowManagementPolicy::handle_request_resize(miral::WindowInfo &/*window_info*/,
-                                                   const MirInputEvent */*input_event*/, MirResizeEdge /*edge*/)
+/*
+    Client-requested moves and resizes are carried out here, see MoveResizeGesture. Input keeps flowing
+    to Qt as usual, so that the pointer and the client's idea of what is pressed stay consistent; the
+    shell is only told when the gesture starts and ends, and sees the resulting geometry changes
+    through the usual (coalesced) notifications.
+ */
+void WindowManagementPolicy::beginMoveResize(miral::WindowInfo &windowInfo, const MirInputEvent *event,
+                                             MirResizeEdge edge)
 {
+    // Only free floating windows can be moved or resized at will
+    if (windowInfo.state() != mir_window_state_restored) {
+        return;
+    }
 
+    if (m_moveResize.window()) {
+        endMoveResize();
+    }
+
+    const auto window = windowInfo.window();
+    if (m_moveResize.begin(window, Rectangle{window.top_left(), window.size()}, event, edge)) {
+        m_windowModel.notifyWindowMoveResizeStarted(windowInfo);
+    }
+}
+
+void WindowManagementPolicy::followMoveResize(const MirInputEvent *event)
+{
+    const auto step = m_moveResize.follow(event);
+    if (step.moved) {
+        auto &windowInfo = tools.info_for(m_moveResize.window());
+        const auto geometry = m_moveResize.geometryAt(step.cursor,
+                                                      Size{windowInfo.min_width(), windowInfo.min_height()},
+                                                      Size{windowInfo.max_width(), windowInfo.max_height()});
+
+        miral::WindowSpecification modifications;
+        modifications.top_left() = geometry.top_left;
+        if (m_moveResize.isResize()) {
+            modifications.size() = geometry.size;
+        }
+        tools.modify_window(windowInfo, modifications);
+    }
+    if (step.released) {
+        endMoveResize();
+    }
+}
+
+void WindowManagementPolicy::endMoveResize()
+{
+    m_windowModel.notifyWindowMoveResizeEnded(tools.info_for(m_moveResize.window()));
+    m_moveResize.reset();
 }
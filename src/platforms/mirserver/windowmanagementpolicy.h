@@ -20,13 +20,22 @@
 #include "miral/canonical_window_manager.h"
 
 #include "appnotifier.h"
+#include "inputtrace.h"
+#include "moveresizegesture.h"
 #include "qteventfeeder.h"
+#include "windowcommand.h"
 #include "windowcontroller.h"
 #include "windowmodelnotifier.h"
 #include "screensmodel.h"
+#include "touchrouter.h"
 
+#include <QMutex>
 #include <QScopedPointer>
 
+#include <atomic>
+
+namespace mir { namespace scene { class Surface; } }
+
 using namespace mir::geometry;
 
 class WindowManagementPolicy : public miral::CanonicalWindowManagerPolicy
@@ -89,28 +98,40 @@ public:
     void deliver_touch_event   (const MirTouchEvent *event,    const miral::Window &window);
     void deliver_pointer_event (const MirPointerEvent *event,  const miral::Window &window);
 
-    void activate(const miral::Window &window);
-    void resize(const miral::Window &window, const Size size);
-    void move  (const miral::Window &window, const Point topLeft);
-    void raise(const miral::Window &window);
-    void requestState(const miral::Window &window, const Mir::State state);
-
-    void ask_client_to_close(const miral::Window &window);
-    void forceClose(const miral::Window &window);
+    void apply(QVector<qtmir::WindowCommand> &commands);
 
     void set_window_confinement_regions(const QVector<QRect> &regions);
     void set_window_margins(MirWindowType windowType, const QMargins &margins);
 
+    void set_direct_input_window(const miral::Window &window, bool enabled);
+    void set_direct_input_allowed(bool allowed);
+    void set_shell_gesture_regions(const QVector<QRect> &regions);
+
 private:
+    void activate(const miral::Window &window);
+    void requestState(const miral::Window &window, const Mir::State state);
     void ensureWindowIsActive(const miral::Window &window);
     QRect getConfinementRect(const QRect rect) const;
+    bool deliverTouchDirectly(const MirTouchEvent *event);
+    void beginMoveResize(miral::WindowInfo &windowInfo, const MirInputEvent *event, MirResizeEdge edge);
+    void followMoveResize(const MirInputEvent *event);
+    void endMoveResize();
 
     qtmir::WindowModelNotifier &m_windowModel;
     qtmir::AppNotifier &m_appNotifier;
     const QSharedPointer<ScreensModel> m_screensModel;
     QtEventFeeder m_eventFeeder;
+    QScopedPointer<qtmir::InputTraceWriter> m_inputTrace; // only when QTMIR_INPUT_TRACE is set
     QVector<QRect> m_confinementRegions;
     QMargins m_windowMargins[mir_window_types];
+
+    // Identifies the surface of the active window, so that input delivery can tell whether it needs
+    // to activate a window without taking the WM lock. Only compared, never dereferenced.
+    std::atomic<const mir::scene::Surface*> m_activeSurface{nullptr};
+
+    qtmir::TouchRouter m_touchRouter;
+
+    qtmir::MoveResizeGesture m_moveResize;
 };
 
 #endif // WINDOWMANAGEMENTPOLICY_H
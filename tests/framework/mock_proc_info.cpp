@@ -28,12 +28,13 @@ MockProcInfo::MockProcInfo()
 
 std::unique_ptr<qtmir::ProcInfo::CommandLine> MockProcInfo::commandLine(pid_t pid)
 {
-    return std::unique_ptr<CommandLine>(new CommandLine{command_line(pid)});
+    // Tests give the arguments separated by spaces
+    return std::unique_ptr<CommandLine>(new CommandLine(command_line(pid).replace(' ', '\0')));
 }
 
 std::unique_ptr<qtmir::ProcInfo::Environment> MockProcInfo::environment(pid_t pid)
 {
-    return std::unique_ptr<Environment>(new Environment{set_environment(pid)});
+    return std::unique_ptr<Environment>(new Environment(set_environment(pid).replace(' ', '\0')));
 }
 
 } // namespace qtmir
@@ -41,6 +41,10 @@ public:
 
     MOCK_METHOD1(setWindowConfinementRegions, void(const QVector<QRect> &regions));
     MOCK_METHOD2(setWindowMargins, void(Mir::Type windowType, const QMargins &margins));
+
+    MOCK_METHOD2(setDirectInputWindow, void(const miral::Window &, bool enabled));
+    MOCK_METHOD1(setDirectInputAllowed, void(bool allowed));
+    MOCK_METHOD1(setShellGestureRegions, void(const QVector<QRect> &regions));
 };
 
 #endif // MOCK_WINDOW_CONTROLLER_H
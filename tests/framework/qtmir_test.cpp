@@ -112,6 +112,7 @@ QtMirTest::QtMirTest()
     , applicationManager(taskControllerSharedPointer,
                          QSharedPointer<MockSharedWakelock>(&sharedWakelock, [](MockSharedWakelock *){}),
                          QSharedPointer<ProcInfo>(&procInfo,[](ProcInfo *){}),
+                         desktopFileIndex,
                          QSharedPointer<MockSettings>(&settings,[](MockSettings *){}))
 {
 }
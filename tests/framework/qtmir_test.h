@@ -25,6 +25,7 @@
 
 #include <Unity/Application/application.h>
 #include <Unity/Application/application_manager.h>
+#include <Unity/Application/desktopfileindex.h>
 #include <Unity/Application/session_interface.h>
 #include <Unity/Application/sharedwakelock.h>
 #include <Unity/Application/proc_info.h>
@@ -75,6 +76,7 @@ public:
 
     QSharedPointer<qtmir::TaskController> taskControllerSharedPointer{new testing::NiceMock<qtmir::MockTaskController>(promptSessionManager)};
     testing::NiceMock<qtmir::MockTaskController> *taskController{static_cast<testing::NiceMock<qtmir::MockTaskController>*>(taskControllerSharedPointer.data())};
+    QSharedPointer<qtmir::DesktopFileIndex> desktopFileIndex{new qtmir::DesktopFileIndex(QStringList())}; // empty
     ApplicationManager applicationManager;
 };
 } // namespace testing
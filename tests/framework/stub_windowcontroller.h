@@ -40,6 +40,10 @@ struct StubWindowModelController : public WindowControllerInterface
 
     void setWindowConfinementRegions(const QVector<QRect> &/*regions*/) override { return; }
     void setWindowMargins(Mir::Type /*windowType*/, const QMargins &/*margins*/) override { return; }
+
+    void setDirectInputWindow(const miral::Window &/*window*/, bool /*enabled*/) override { return; }
+    void setDirectInputAllowed(bool /*allowed*/) override { return; }
+    void setShellGestureRegions(const QVector<QRect> &/*regions*/) override { return; }
 };
 
 } //namespace qtmir
@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cursor.h>
+#include <hardwarecursor.h>
+#include <mircursorimages.h>
+
+#include <QGuiApplication>
+#include <QVector>
+
+#include <functional>
+#include <thread>
+
+// Unity API
+#include <unity/shell/application/MirMousePointerInterface.h>
+
+// mir
+#include <mir/graphics/cursor.h>
+
+using namespace qtmir;
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Mock;
+using ::testing::NiceMock;
+
+namespace {
+
+struct PointerEvent {
+    enum Type { Mouse, Wheel };
+    Type type;
+    QPointF movement;
+    Qt::MouseButtons buttons;
+    QPoint angleDelta;
+};
+
+// Records what it gets, in order
+class FakeMousePointer : public MirMousePointerInterface
+{
+public:
+    void setCursorName(const QString &cursorName) { m_cursorName = cursorName; }
+    QString cursorName() const { return m_cursorName; }
+    void setThemeName(const QString &) {}
+    QString themeName() const { return QString(); }
+    void setCustomCursor(const QCursor &) {}
+    qreal hotspotX() const { return 0; }
+    qreal hotspotY() const { return 0; }
+
+    void handleMouseEvent(ulong /*timestamp*/, QPointF movement, Qt::MouseButtons buttons,
+                          Qt::KeyboardModifiers /*modifiers*/)
+    {
+        events.append(PointerEvent{PointerEvent::Mouse, movement, buttons, QPoint()});
+    }
+
+    void handleWheelEvent(ulong /*timestamp*/, QPoint angleDelta, Qt::KeyboardModifiers /*modifiers*/)
+    {
+        events.append(PointerEvent{PointerEvent::Wheel, QPointF(), Qt::NoButton, angleDelta});
+    }
+
+    QVector<PointerEvent> events;
+
+private:
+    QString m_cursorName;
+};
+
+struct MockMirCursor : public mir::graphics::Cursor
+{
+    MOCK_METHOD0(show, void());
+    MOCK_METHOD1(show, void(mir::graphics::CursorImage const&));
+    MOCK_METHOD0(hide, void());
+    MOCK_METHOD1(move_to, void(mir::geometry::Point));
+};
+
+} // anonymous namespace
+
+class CursorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        int argc = 0;
+        char **argv = nullptr;
+        setenv("QT_QPA_PLATFORM", "minimal", 1);
+        app = new QGuiApplication(argc, argv);
+
+        // as done by QtEventFeeder, for the calls queued from the input thread
+        qRegisterMetaType<Qt::KeyboardModifiers>("Qt::KeyboardModifiers");
+        qRegisterMetaType<Qt::MouseButtons>("Qt::MouseButtons");
+
+        mousePointer = new FakeMousePointer;
+        cursor = new Cursor;
+        cursor->setMousePointer(mousePointer);
+    }
+
+    void TearDown() override
+    {
+        cursor->setMousePointer(nullptr);
+        delete cursor;
+        delete mousePointer;
+        delete app;
+    }
+
+    // Cursor is fed from the Mir input thread
+    void onInputThread(const std::function<void()> &input)
+    {
+        std::thread inputThread(input);
+        inputThread.join();
+    }
+
+    QGuiApplication *app;
+    FakeMousePointer *mousePointer;
+    Cursor *cursor;
+};
+
+TEST_F(CursorTest, coalescesMotion)
+{
+    onInputThread([this]() {
+        for (int i = 0; i < 100; ++i) {
+            cursor->handleMouseEvent(i, QPointF(1, 2), Qt::NoButton, Qt::NoModifier);
+        }
+    });
+    QCoreApplication::processEvents();
+
+    ASSERT_EQ(1, mousePointer->events.count());
+    EXPECT_EQ(PointerEvent::Mouse, mousePointer->events[0].type);
+    EXPECT_EQ(QPointF(100, 200), mousePointer->events[0].movement);
+}
+
+/*
+   Motion is coalesced but button and wheel events are not, so the MousePointer must see every
+   one of them, at the position the pointer had when they happened, and no motion may get lost.
+ */
+TEST_F(CursorTest, keepsMotionInOrderWithButtonAndWheelEvents)
+{
+    onInputThread([this]() {
+        for (int i = 0; i < 3; ++i) {
+            cursor->handleMouseEvent(0, QPointF(1, 0), Qt::NoButton, Qt::NoModifier);
+        }
+        cursor->handleMouseEvent(1, QPointF(0, 0), Qt::LeftButton, Qt::NoModifier);
+        for (int i = 0; i < 2; ++i) {
+            cursor->handleMouseEvent(2, QPointF(0, 1), Qt::LeftButton, Qt::NoModifier);
+        }
+        cursor->handleWheelEvent(3, QPoint(0, 120), Qt::NoModifier);
+        cursor->handleMouseEvent(4, QPointF(2, 2), Qt::LeftButton, Qt::NoModifier);
+        cursor->handleMouseEvent(5, QPointF(0, 0), Qt::NoButton, Qt::NoModifier);
+        cursor->handleMouseEvent(6, QPointF(1, 1), Qt::NoButton, Qt::NoModifier);
+    });
+    QCoreApplication::processEvents();
+
+    // Replay what the MousePointer got: where the pointer was at each discrete event
+    QPointF position;
+    QVector<QPointF> pressPositions, releasePositions, wheelPositions;
+    Qt::MouseButtons buttons = Qt::NoButton;
+    for (const PointerEvent &event : mousePointer->events) {
+        if (event.type == PointerEvent::Wheel) {
+            wheelPositions.append(position);
+            EXPECT_EQ(QPoint(0, 120), event.angleDelta);
+            continue;
+        }
+        position += event.movement;
+        if (event.buttons != buttons) {
+            (event.buttons ? pressPositions : releasePositions).append(position);
+            buttons = event.buttons;
+        }
+    }
+
+    EXPECT_EQ(QVector<QPointF>({QPointF(3, 0)}), pressPositions);
+    EXPECT_EQ(QVector<QPointF>({QPointF(3, 2)}), wheelPositions);
+    EXPECT_EQ(QVector<QPointF>({QPointF(5, 4)}), releasePositions);
+    EXPECT_EQ(QPointF(6, 5), position);
+    EXPECT_EQ(Qt::MouseButtons(Qt::NoButton), buttons);
+}
+
+TEST_F(CursorTest, keepsMotionInOrderWhileGuiThreadCatchesUp)
+{
+    QPointF expectedPosition;
+    int expectedWheelEvents = 0;
+
+    for (int round = 0; round < 10; ++round) {
+        onInputThread([this, round, &expectedPosition, &expectedWheelEvents]() {
+            for (int i = 0; i < 10; ++i) {
+                cursor->handleMouseEvent(i, QPointF(1, 1), Qt::NoButton, Qt::NoModifier);
+                expectedPosition += QPointF(1, 1);
+            }
+            cursor->handleMouseEvent(10, QPointF(0, 0), Qt::LeftButton, Qt::NoModifier);
+            if (round % 2) {
+                cursor->handleWheelEvent(11, QPoint(0, -120), Qt::NoModifier);
+                ++expectedWheelEvents;
+            }
+            cursor->handleMouseEvent(12, QPointF(0, 0), Qt::NoButton, Qt::NoModifier);
+        });
+
+        // Deliver only part of the backlog now and then
+        if (round % 3 == 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+    QCoreApplication::processEvents();
+
+    QPointF position;
+    int presses = 0, releases = 0, wheelEvents = 0;
+    Qt::MouseButtons buttons = Qt::NoButton;
+    for (const PointerEvent &event : mousePointer->events) {
+        if (event.type == PointerEvent::Wheel) {
+            // a wheel event only comes with the button held in this sequence
+            EXPECT_EQ(Qt::MouseButtons(Qt::LeftButton), buttons);
+            ++wheelEvents;
+            continue;
+        }
+        position += event.movement;
+        if (event.buttons != buttons) {
+            event.buttons ? ++presses : ++releases;
+            buttons = event.buttons;
+        }
+    }
+
+    EXPECT_EQ(10, presses);
+    EXPECT_EQ(10, releases);
+    EXPECT_EQ(expectedWheelEvents, wheelEvents);
+    EXPECT_EQ(expectedPosition, position);
+}
+
+class HardwareCursorModeTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        int argc = 0;
+        char **argv = nullptr;
+        setenv("QT_QPA_PLATFORM", "minimal", 1);
+        app = new QGuiApplication(argc, argv);
+
+        mirCursor = std::make_shared<NiceMock<MockMirCursor>>();
+        hardwareCursor = new HardwareCursor(mirCursor, std::make_shared<MirCursorImages>());
+        mousePointer = new FakeMousePointer;
+        cursor = new Cursor(hardwareCursor);
+    }
+
+    void TearDown() override
+    {
+        delete cursor;
+        delete mousePointer;
+        delete hardwareCursor;
+        delete app;
+    }
+
+    QGuiApplication *app;
+    std::shared_ptr<NiceMock<MockMirCursor>> mirCursor;
+    HardwareCursor *hardwareCursor;
+    FakeMousePointer *mousePointer;
+    Cursor *cursor;
+};
+
+TEST_F(HardwareCursorModeTest, leavesPointerVisibilityToTheShell)
+{
+    mousePointer->setOpacity(0.5);
+
+    cursor->setMousePointer(mousePointer);
+
+    // not drawn, but still visible as far as the shell is concerned
+    EXPECT_TRUE(mousePointer->isVisible());
+    EXPECT_EQ(0, mousePointer->opacity());
+
+    cursor->setMousePointer(nullptr);
+
+    EXPECT_TRUE(mousePointer->isVisible());
+    EXPECT_EQ(0.5, mousePointer->opacity());
+}
+
+TEST_F(HardwareCursorModeTest, hardwareCursorFollowsPointerVisibility)
+{
+    EXPECT_CALL(*mirCursor, show(testing::A<mir::graphics::CursorImage const&>())).Times(1);
+    cursor->setMousePointer(mousePointer);
+    ASSERT_TRUE(Mock::VerifyAndClearExpectations(mirCursor.get()));
+
+    EXPECT_CALL(*mirCursor, hide()).Times(1);
+    mousePointer->setVisible(false);
+    ASSERT_TRUE(Mock::VerifyAndClearExpectations(mirCursor.get()));
+
+    EXPECT_CALL(*mirCursor, show(testing::A<mir::graphics::CursorImage const&>())).Times(1);
+    mousePointer->setVisible(true);
+    ASSERT_TRUE(Mock::VerifyAndClearExpectations(mirCursor.get()));
+
+    EXPECT_TRUE(mousePointer->isVisible());
+}
+
+TEST_F(HardwareCursorModeTest, pointerEventsGoStraightToQt)
+{
+    cursor->setMousePointer(mousePointer);
+
+    EXPECT_FALSE(cursor->handleMouseEvent(0, QPointF(1, 1), Qt::NoButton, Qt::NoModifier));
+    EXPECT_FALSE(cursor->handleWheelEvent(0, QPoint(0, 120), Qt::NoModifier));
+}
@@ -156,3 +156,37 @@ TEST_F(EventBuilderTest, ReconstructDeviceId)
     auto input_event = mir_event_get_input_event(newMirEvent.get());
     EXPECT_EQ(deviceId, mir_input_event_get_device_id(input_event));
 }
+
+/*
+ Once the ring buffer has wrapped around, storing new events should recycle the existing
+ EventInfo storage instead of allocating new cookie buffers.
+ */
+TEST_F(EventBuilderTest, StoreRecyclesEventInfos)
+{
+    QScopedPointer<EventBuilder> eventBuilder(new EventBuilder);
+
+    std::vector<uint8_t> cookie{0xd7, 0x56, 0xf1, 0xb7, 0xd8, 0xba};
+    const int ringSize = 10;
+    ulong qtTimestamp = 12345;
+
+    auto storeEvent = [&](ulong timestamp) {
+        mir::EventUPtr mirEvent = mir::events::make_event(0 /*DeviceID */, std::chrono::nanoseconds(timestamp)/*timestamp*/,
+                cookie, mir_input_event_modifier_none, mir_pointer_action_motion, 0 /*buttons*/,
+                0 /*x*/, 0 /*y*/, 0 /*hscroll*/, 0 /*vscroll*/, 0 /*relativeX*/, 0 /*relativeY*/);
+        eventBuilder->store(mir_event_get_input_event(mirEvent.get()), timestamp);
+    };
+
+    std::vector<const uint8_t*> cookieBuffers;
+    for (int i = 0; i < ringSize; ++i) {
+        storeEvent(qtTimestamp + i);
+        cookieBuffers.push_back(eventBuilder->findInfo(qtTimestamp + i)->cookie.data());
+    }
+
+    for (int i = 0; i < ringSize; ++i) {
+        storeEvent(qtTimestamp + ringSize + i);
+        auto eventInfo = eventBuilder->findInfo(qtTimestamp + ringSize + i);
+        ASSERT_NE(nullptr, eventInfo);
+        EXPECT_EQ(cookieBuffers[i], eventInfo->cookie.data());
+        EXPECT_EQ(nullptr, eventBuilder->findInfo(qtTimestamp + i));
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <inputtrace.h>
+
+#include <QTemporaryFile>
+
+#include "mir/events/event_builders.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace qtmir;
+namespace mev = mir::events;
+
+class InputTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(traceFile.open());
+        traceFile.close();
+    }
+
+    QTemporaryFile traceFile;
+};
+
+/*
+ Events read back from a trace must carry everything the input path looks at
+ */
+TEST_F(InputTraceTest, EventsSurviveRoundTrip)
+{
+    {
+        InputTraceWriter writer(traceFile.fileName());
+        ASSERT_TRUE(writer.isOpen());
+
+        auto key = mev::make_event(3 /*DeviceID*/, std::chrono::nanoseconds(1000), std::vector<uint8_t>{1, 2, 3},
+                                   mir_keyboard_action_down, 0x61 /*keysym*/, 30 /*scan code*/,
+                                   mir_input_event_modifier_shift);
+        writer.record(mir_event_get_input_event(key.get()));
+
+        auto touch = mev::make_event(4 /*DeviceID*/, std::chrono::nanoseconds(2000), std::vector<uint8_t>{},
+                                     mir_input_event_modifier_none);
+        mev::add_touch(*touch, 0, mir_touch_action_down, mir_touch_tooltype_finger, 10, 20, 0.5, 4, 3, 0);
+        mev::add_touch(*touch, 1, mir_touch_action_change, mir_touch_tooltype_finger, 30, 40, 0.7, 5, 2, 0);
+        writer.record(mir_event_get_input_event(touch.get()));
+
+        auto pointer = mev::make_event(5 /*DeviceID*/, std::chrono::nanoseconds(3000), std::vector<uint8_t>{},
+                                       mir_input_event_modifier_ctrl, mir_pointer_action_button_down,
+                                       mir_pointer_button_primary, 100, 200, 0, 1, 1.5, -2.5);
+        writer.record(mir_event_get_input_event(pointer.get()));
+    }
+
+    InputTraceReader reader(traceFile.fileName());
+    ASSERT_TRUE(reader.isValid());
+
+    InputTraceReader::Entry entry;
+
+    ASSERT_TRUE(reader.readNext(entry));
+    {
+        auto iev = mir_event_get_input_event(entry.event.get());
+        ASSERT_EQ(mir_input_event_type_key, mir_input_event_get_type(iev));
+        EXPECT_EQ(3, mir_input_event_get_device_id(iev));
+        EXPECT_EQ(1000, mir_input_event_get_event_time(iev));
+        auto kev = mir_input_event_get_keyboard_event(iev);
+        EXPECT_EQ(mir_keyboard_action_down, mir_keyboard_event_action(kev));
+        EXPECT_EQ(0x61u, mir_keyboard_event_key_code(kev));
+        EXPECT_EQ(30, mir_keyboard_event_scan_code(kev));
+        EXPECT_EQ(mir_input_event_modifier_shift, mir_keyboard_event_modifiers(kev));
+    }
+
+    ASSERT_TRUE(reader.readNext(entry));
+    {
+        auto iev = mir_event_get_input_event(entry.event.get());
+        ASSERT_EQ(mir_input_event_type_touch, mir_input_event_get_type(iev));
+        EXPECT_EQ(2000, mir_input_event_get_event_time(iev));
+        auto tev = mir_input_event_get_touch_event(iev);
+        ASSERT_EQ(2u, mir_touch_event_point_count(tev));
+        EXPECT_EQ(1, mir_touch_event_id(tev, 1));
+        EXPECT_EQ(mir_touch_action_change, mir_touch_event_action(tev, 1));
+        EXPECT_FLOAT_EQ(30, mir_touch_event_axis_value(tev, 1, mir_touch_axis_x));
+        EXPECT_FLOAT_EQ(40, mir_touch_event_axis_value(tev, 1, mir_touch_axis_y));
+        EXPECT_FLOAT_EQ(0.7, mir_touch_event_axis_value(tev, 1, mir_touch_axis_pressure));
+    }
+
+    ASSERT_TRUE(reader.readNext(entry));
+    {
+        auto iev = mir_event_get_input_event(entry.event.get());
+        ASSERT_EQ(mir_input_event_type_pointer, mir_input_event_get_type(iev));
+        auto pev = mir_input_event_get_pointer_event(iev);
+        EXPECT_EQ(mir_pointer_action_button_down, mir_pointer_event_action(pev));
+        EXPECT_EQ(mir_pointer_button_primary, mir_pointer_event_buttons(pev));
+        EXPECT_EQ(mir_input_event_modifier_ctrl, mir_pointer_event_modifiers(pev));
+        EXPECT_FLOAT_EQ(100, mir_pointer_event_axis_value(pev, mir_pointer_axis_x));
+        EXPECT_FLOAT_EQ(1, mir_pointer_event_axis_value(pev, mir_pointer_axis_vscroll));
+        EXPECT_FLOAT_EQ(-2.5, mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_y));
+    }
+
+    EXPECT_FALSE(reader.readNext(entry));
+}
+
+TEST_F(InputTraceTest, RejectsFilesThatAreNotTraces)
+{
+    ASSERT_TRUE(traceFile.open());
+    traceFile.write("definitely not an input trace");
+    traceFile.close();
+
+    InputTraceReader reader(traceFile.fileName());
+    EXPECT_FALSE(reader.isValid());
+}
+
+TEST_F(InputTraceTest, ReplayDispatchesEveryEventInOrder)
+{
+    {
+        InputTraceWriter writer(traceFile.fileName());
+        for (int i = 0; i < 5; ++i) {
+            auto pointer = mev::make_event(0 /*DeviceID*/, std::chrono::nanoseconds(i), std::vector<uint8_t>{},
+                                           mir_input_event_modifier_none, mir_pointer_action_motion, 0 /*buttons*/,
+                                           i, i, 0, 0, 1, 1);
+            writer.record(mir_event_get_input_event(pointer.get()));
+        }
+    }
+
+    InputTraceReader reader(traceFile.fileName());
+    std::vector<int64_t> times;
+    const int count = replayInputTrace(reader, [&times](const MirEvent &event) {
+        times.push_back(mir_input_event_get_event_time(mir_event_get_input_event(&event)));
+    }, 0 /* as fast as possible */);
+
+    EXPECT_EQ(5, count);
+    EXPECT_EQ((std::vector<int64_t>{0, 1, 2, 3, 4}), times);
+}
+
+/*
+ Recording only buffers events, writing them out happens elsewhere and in chunks. None may get lost
+ on the way, however much gets buffered.
+ */
+TEST_F(InputTraceTest, WritesEveryBufferedEvent)
+{
+    const int eventCount = 10000;
+    {
+        InputTraceWriter writer(traceFile.fileName());
+        for (int i = 0; i < eventCount; ++i) {
+            auto touch = mev::make_event(0 /*DeviceID*/, std::chrono::nanoseconds(i), std::vector<uint8_t>{},
+                                         mir_input_event_modifier_none);
+            mev::add_touch(*touch, 0, mir_touch_action_change, mir_touch_tooltype_finger, i, i, 1, 1, 1, 0);
+            mev::add_touch(*touch, 1, mir_touch_action_change, mir_touch_tooltype_finger, i, i, 1, 1, 1, 0);
+            writer.record(mir_event_get_input_event(touch.get()));
+        }
+    }
+
+    InputTraceReader reader(traceFile.fileName());
+    ASSERT_TRUE(reader.isValid());
+
+    int64_t expectedTime = 0;
+    const int count = replayInputTrace(reader, [&expectedTime](const MirEvent &event) {
+        EXPECT_EQ(expectedTime++, mir_input_event_get_event_time(mir_event_get_input_event(&event)));
+    }, 0 /* as fast as possible */);
+
+    EXPECT_EQ(eventCount, count);
+}
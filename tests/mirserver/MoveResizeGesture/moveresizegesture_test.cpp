@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <moveresizegesture.h>
+
+#include "mir/events/event_builders.h"
+
+// mirtest
+#include <mir/test/doubles/stub_session.h>
+#include <mir/test/doubles/stub_surface.h>
+
+#include <vector>
+
+using namespace qtmir;
+using namespace mir::geometry;
+
+namespace mev = mir::events;
+
+using StubSurface = mir::test::doubles::StubSurface;
+using StubSession = mir::test::doubles::StubSession;
+
+namespace {
+
+struct Touch {
+    int id;
+    MirTouchAction action;
+    float x;
+    float y;
+};
+
+const Rectangle startGeometry{Point{100, 100}, Size{400, 300}};
+const Size noMinSize{1, 1};
+const Size noMaxSize{10000, 10000};
+
+} // anonymous namespace
+
+class MoveResizeGestureTest : public ::testing::Test
+{
+protected:
+    MoveResizeGestureTest()
+        : window(std::make_shared<StubSession>(), std::make_shared<StubSurface>())
+    {
+    }
+
+    mir::EventUPtr pointerEvent(float x, float y, MirPointerButtons buttons = mir_pointer_button_primary)
+    {
+        return mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(123), std::vector<uint8_t>{} /* cookie */,
+                               mir_input_event_modifier_none, mir_pointer_action_motion, buttons,
+                               x, y, 0, 0, 0, 0);
+    }
+
+    mir::EventUPtr touchEvent(const std::vector<Touch> &touches)
+    {
+        auto ev = mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(123), std::vector<uint8_t>{} /* cookie */, 0);
+        for (const auto &touch : touches) {
+            mev::add_touch(*ev, touch.id, touch.action, mir_touch_tooltype_finger,
+                           touch.x, touch.y, 10 /* pressure */,
+                           1, 1, 10 /* touch major, minor, size */);
+        }
+        return ev;
+    }
+
+    static const MirInputEvent *input(const mir::EventUPtr &ev)
+    {
+        return mir_event_get_input_event(ev.get());
+    }
+
+    // Moves the pointer that started the gesture and returns the resulting geometry
+    Rectangle dragPointerTo(float x, float y, const Size minSize = noMinSize, const Size maxSize = noMaxSize)
+    {
+        const auto step = gesture.follow(input(pointerEvent(x, y)));
+        EXPECT_TRUE(step.moved);
+        EXPECT_FALSE(step.released);
+        return gesture.geometryAt(step.cursor, minSize, maxSize);
+    }
+
+    MoveResizeGesture gesture;
+    miral::Window window;
+};
+
+TEST_F(MoveResizeGestureTest, moveFollowsThePointerDelta)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(150, 110)), mir_resize_edge_none));
+    EXPECT_FALSE(gesture.isResize());
+
+    EXPECT_EQ(Rectangle(Point{130, 80}, Size{400, 300}), dragPointerTo(180, 90));
+    EXPECT_EQ(Rectangle(Point{90, 140}, Size{400, 300}), dragPointerTo(140, 150));
+}
+
+TEST_F(MoveResizeGestureTest, eastResizeKeepsTheWestEdge)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(500, 200)), mir_resize_edge_east));
+    EXPECT_TRUE(gesture.isResize());
+
+    EXPECT_EQ(Rectangle(Point{100, 100}, Size{450, 300}), dragPointerTo(550, 260));
+}
+
+TEST_F(MoveResizeGestureTest, westResizeKeepsTheEastEdge)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(100, 200)), mir_resize_edge_west));
+
+    EXPECT_EQ(Rectangle(Point{60, 100}, Size{440, 300}), dragPointerTo(60, 230));
+    EXPECT_EQ(Rectangle(Point{150, 100}, Size{350, 300}), dragPointerTo(150, 230));
+}
+
+TEST_F(MoveResizeGestureTest, northResizeKeepsTheSouthEdge)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(300, 100)), mir_resize_edge_north));
+
+    EXPECT_EQ(Rectangle(Point{100, 70}, Size{400, 330}), dragPointerTo(320, 70));
+}
+
+TEST_F(MoveResizeGestureTest, northWestResizeKeepsTheSouthEastCorner)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(100, 100)), mir_resize_edge_northwest));
+
+    EXPECT_EQ(Rectangle(Point{120, 130}, Size{380, 270}), dragPointerTo(120, 130));
+}
+
+TEST_F(MoveResizeGestureTest, resizeIsClampedToTheMinimumSize)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(100, 100)), mir_resize_edge_northwest));
+
+    // The south east corner stays put, even though the cursor went past it
+    EXPECT_EQ(Rectangle(Point{300, 350}, Size{200, 50}), dragPointerTo(700, 700, Size{200, 50}, noMaxSize));
+}
+
+TEST_F(MoveResizeGestureTest, resizeIsClampedToTheMaximumSize)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(500, 400)), mir_resize_edge_southeast));
+
+    EXPECT_EQ(Rectangle(Point{100, 100}, Size{500, 350}), dragPointerTo(900, 900, noMinSize, Size{500, 350}));
+}
+
+TEST_F(MoveResizeGestureTest, pointerGestureEndsWhenButtonsAreReleased)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(150, 110)), mir_resize_edge_none));
+
+    const auto step = gesture.follow(input(pointerEvent(160, 120, 0)));
+    EXPECT_TRUE(step.moved);
+    EXPECT_EQ(Point(160, 120), step.cursor);
+    EXPECT_TRUE(step.released);
+}
+
+TEST_F(MoveResizeGestureTest, pointerGestureIgnoresTouches)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(150, 110)), mir_resize_edge_none));
+
+    const auto step = gesture.follow(input(touchEvent({{0, mir_touch_action_up, 10, 10}})));
+    EXPECT_FALSE(step.moved);
+    EXPECT_FALSE(step.released);
+}
+
+TEST_F(MoveResizeGestureTest, touchGestureFollowsTheTouchThatStartedIt)
+{
+    // Touch 4 goes down while touch 1 is already down
+    ASSERT_TRUE(gesture.begin(window, startGeometry,
+                              input(touchEvent({{1, mir_touch_action_change, 10, 10},
+                                                {4, mir_touch_action_down, 150, 110}})),
+                              mir_resize_edge_none));
+
+    const auto step = gesture.follow(input(touchEvent({{1, mir_touch_action_change, 20, 20},
+                                                       {4, mir_touch_action_change, 170, 140}})));
+    ASSERT_TRUE(step.moved);
+    EXPECT_FALSE(step.released);
+    EXPECT_EQ(Point(170, 140), step.cursor);
+    EXPECT_EQ(Rectangle(Point{120, 130}, Size{400, 300}), gesture.geometryAt(step.cursor, noMinSize, noMaxSize));
+}
+
+TEST_F(MoveResizeGestureTest, touchGestureOutlivesOtherTouches)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry,
+                              input(touchEvent({{1, mir_touch_action_change, 10, 10},
+                                                {4, mir_touch_action_down, 150, 110}})),
+                              mir_resize_edge_none));
+
+    auto step = gesture.follow(input(touchEvent({{1, mir_touch_action_up, 10, 10},
+                                                 {4, mir_touch_action_change, 150, 110}})));
+    EXPECT_FALSE(step.released);
+
+    step = gesture.follow(input(touchEvent({{4, mir_touch_action_change, 160, 110}})));
+    EXPECT_TRUE(step.moved);
+    EXPECT_FALSE(step.released);
+}
+
+TEST_F(MoveResizeGestureTest, touchGestureEndsWhenItsTouchIsReleased)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry,
+                              input(touchEvent({{1, mir_touch_action_change, 10, 10},
+                                                {4, mir_touch_action_down, 150, 110}})),
+                              mir_resize_edge_none));
+
+    // Other touches still down
+    const auto step = gesture.follow(input(touchEvent({{1, mir_touch_action_change, 10, 10},
+                                                       {4, mir_touch_action_up, 155, 115}})));
+    EXPECT_TRUE(step.moved);
+    EXPECT_EQ(Point(155, 115), step.cursor);
+    EXPECT_TRUE(step.released);
+}
+
+TEST_F(MoveResizeGestureTest, touchGestureEndsWhenItsTouchGoesMissing)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(touchEvent({{4, mir_touch_action_down, 150, 110}})),
+                              mir_resize_edge_none));
+
+    // The release of touch 4 never arrived
+    const auto step = gesture.follow(input(touchEvent({{5, mir_touch_action_down, 300, 300}})));
+    EXPECT_FALSE(step.moved);
+    EXPECT_TRUE(step.released);
+}
+
+TEST_F(MoveResizeGestureTest, doesNotBeginWithoutAPosition)
+{
+    EXPECT_FALSE(gesture.begin(window, startGeometry, input(touchEvent({})), mir_resize_edge_none));
+    EXPECT_FALSE(gesture.window());
+}
+
+TEST_F(MoveResizeGestureTest, followsNothingOnceReset)
+{
+    ASSERT_TRUE(gesture.begin(window, startGeometry, input(pointerEvent(150, 110)), mir_resize_edge_none));
+    EXPECT_EQ(window, gesture.window());
+
+    gesture.reset();
+
+    EXPECT_FALSE(gesture.window());
+    EXPECT_FALSE(gesture.follow(input(pointerEvent(160, 120))).moved);
+}
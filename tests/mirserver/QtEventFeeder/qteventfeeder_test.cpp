@@ -30,6 +30,10 @@
 #include <linux/input.h>
 #include <xkbcommon/xkbcommon-keysyms.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
 using ::testing::_;
 using ::testing::AllOf;
 using ::testing::AnyNumber;
@@ -49,6 +53,42 @@ using ::testing::StateIsMoved;
 
 namespace mev = mir::events;
 
+// Counts heap allocations made by the current thread while enabled, so that tests can
+// check what the input path allocates per event.
+namespace {
+std::atomic<int> allocationCount{0};
+thread_local bool countAllocations = false;
+
+class AllocationCounter
+{
+public:
+    AllocationCounter() { allocationCount = 0; countAllocations = true; }
+    ~AllocationCounter() { countAllocations = false; }
+    int count() const { return allocationCount; }
+};
+} // anonymous namespace
+
+void *operator new(std::size_t size)
+{
+    if (countAllocations) {
+        ++allocationCount;
+    }
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 // used by google mock in error messages
 void PrintTo(const struct QWindowSystemInterface::TouchPoint& touchPoint, ::std::ostream* os) {
     *os << "TouchPoint("
@@ -321,3 +361,140 @@ TEST_F(QtEventFeederTest, composeKeysNotFilteredOut)
     dispatch_key_event(up, KEY_RIGHTSHIFT, XKB_KEY_Shift_R);
     dispatch_key_event(down, KEY_U, XKB_KEY_udiaeresis);
 }
+
+/*
+   Mir allows more simultaneous touches than QtEventFeeder keeps inline. Touches past that
+   capacity must still be tracked: moved rather than re-pressed, and released when they
+   go missing.
+ */
+TEST_F(QtEventFeederTest, TracksMoreTouchesThanInlineCapacity)
+{
+    const int touchCount = 12;
+
+    setIrrelevantMockWindowSystemExpectations();
+
+    EXPECT_CALL(*mockWindowSystem, handleTouchEvent(_,_,_,AllOf(SizeIs(touchCount),
+                                                              Contains(AllOf(HasId(10), IsPressed())),
+                                                              Contains(AllOf(HasId(11), IsPressed()))),_)).Times(1);
+
+    auto ev1 = mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(123), std::vector<uint8_t>{} /* cookie */, 0);
+    for (int id = 0; id < touchCount; ++id) {
+        mev::add_touch(*ev1, id, mir_touch_action_down, mir_touch_tooltype_unknown,
+                       10 * id, 10, 10 /* x, y, pressure */,
+                       1, 1, 10 /* touch major, minor, size */);
+    }
+    qtEventFeeder->dispatch(*ev1);
+
+    ASSERT_TRUE(Mock::VerifyAndClearExpectations(mockWindowSystem));
+
+    setIrrelevantMockWindowSystemExpectations();
+
+    // touch 11 disappeared, every other one moved
+    {
+        InSequence sequence;
+
+        EXPECT_CALL(*mockWindowSystem,
+            handleTouchEvent(_,_,_,AllOf(SizeIs(touchCount),
+                                       Contains(AllOf(HasId(11), IsReleased())),
+                                       Contains(AllOf(HasId(10), IsStationary()))
+                                       ),_)).Times(1);
+
+        EXPECT_CALL(*mockWindowSystem,
+            handleTouchEvent(_,_,_,AllOf(SizeIs(touchCount - 1),
+                                       Contains(AllOf(HasId(0), StateIsMoved())),
+                                       Contains(AllOf(HasId(10), StateIsMoved()))
+                                       ),_)).Times(1);
+    }
+
+    auto ev2 = mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(124), std::vector<uint8_t>{} /* cookie */, 0);
+    for (int id = 0; id < touchCount - 1; ++id) {
+        mev::add_touch(*ev2, id, mir_touch_action_change, mir_touch_tooltype_unknown,
+                       10 * id, 20, 10 /* x, y, pressure */,
+                       1, 1, 10 /* touch major, minor, size */);
+    }
+    qtEventFeeder->dispatch(*ev2);
+
+    ASSERT_TRUE(Mock::VerifyAndClearExpectations(mockWindowSystem));
+
+    setIrrelevantMockWindowSystemExpectations();
+
+    // releasing touch 10 must find it, so it's forwarded rather than ignored
+    EXPECT_CALL(*mockWindowSystem,
+        handleTouchEvent(_,_,_,AllOf(SizeIs(touchCount - 1),
+                                   Contains(AllOf(HasId(10), IsReleased()))
+                                   ),_)).Times(1);
+
+    auto ev3 = mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(125), std::vector<uint8_t>{} /* cookie */, 0);
+    for (int id = 0; id < touchCount - 1; ++id) {
+        mev::add_touch(*ev3, id, id == 10 ? mir_touch_action_up : mir_touch_action_change,
+                       mir_touch_tooltype_unknown,
+                       10 * id, 20, 10 /* x, y, pressure */,
+                       1, 1, 10 /* touch major, minor, size */);
+    }
+    qtEventFeeder->dispatch(*ev3);
+
+    ASSERT_TRUE(Mock::VerifyAndClearExpectations(mockWindowSystem));
+}
+
+namespace {
+
+// Does nothing with the events, so that only QtEventFeeder's own allocations get counted
+class NullQtWindowSystem : public QtEventFeeder::QtWindowSystemInterface
+{
+public:
+    NullQtWindowSystem(QWindow *window) : m_window(window) {}
+    ~NullQtWindowSystem() { qDeleteAll(m_devices); }
+
+    QWindow* getWindowForTouchPoint(const QPoint &) override { return m_window; }
+    QWindow* focusedWindow() override { return m_window; }
+    void registerTouchDevice(QTouchDevice *device) override { m_devices << device; }
+    void handleExtendedKeyEvent(QWindow *, ulong, QEvent::Type, int, Qt::KeyboardModifiers,
+                                quint32, quint32, quint32, const QString&, bool, ushort) override {}
+    void handleTouchEvent(QWindow *, ulong, QTouchDevice *,
+                          const QList<struct QWindowSystemInterface::TouchPoint> &,
+                          Qt::KeyboardModifiers) override {}
+    void handleMouseEvent(ulong, QPointF, QPointF, Qt::MouseButtons, Qt::KeyboardModifiers) override {}
+    void handleWheelEvent(ulong, QPointF, QPoint, Qt::KeyboardModifiers) override {}
+
+private:
+    QWindow *m_window;
+    QVector<QTouchDevice*> m_devices;
+};
+
+} // anonymous namespace
+
+/*
+   Once warmed up, dispatching a touch event must not allocate beyond the QList that
+   QWindowSystemInterface::handleTouchEvent takes: one block for the list itself plus
+   one node per touch point, as QList stores large types indirectly.
+ */
+TEST_F(QtEventFeederTest, SteadyStateTouchDispatchAllocatesOnlyTheQtTouchList)
+{
+    const int touchCount = 3;
+    QtEventFeeder feeder(new NullQtWindowSystem(window));
+
+    auto makeTouchEvent = [&](int n, MirTouchAction action) {
+        auto ev = mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(100 + n),
+                                  std::vector<uint8_t>{} /* cookie */, 0);
+        for (int id = 0; id < touchCount; ++id) {
+            mev::add_touch(*ev, id, action, mir_touch_tooltype_unknown,
+                           10 * id + n, 10, 10 /* x, y, pressure */,
+                           1, 1, 10 /* touch major, minor, size */);
+        }
+        return ev;
+    };
+
+    // Warm up: first press, and enough events to fill EventBuilder's ring buffer
+    feeder.dispatch(*makeTouchEvent(0, mir_touch_action_down));
+    for (int n = 1; n < 20; ++n) {
+        feeder.dispatch(*makeTouchEvent(n, mir_touch_action_change));
+    }
+
+    for (int n = 20; n < 30; ++n) {
+        auto ev = makeTouchEvent(n, mir_touch_action_change);
+
+        AllocationCounter counter;
+        feeder.dispatch(*ev);
+        EXPECT_LE(counter.count(), 1 + touchCount);
+    }
+}
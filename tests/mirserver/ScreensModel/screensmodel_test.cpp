@@ -32,6 +32,9 @@
 
 #include <QGuiApplication>
 #include <QLoggingCategory>
+#include <QThread>
+
+#include <thread>
 
 using namespace ::testing;
 
@@ -188,3 +191,52 @@ TEST_F(ScreensModelTest, MultipleMatchBuffersWithDisplays)
     static_cast<StubScreen*>(screensModel->screens().at(0))->makeCurrent();
     static_cast<StubScreen*>(screensModel->screens().at(1))->makeCurrent();
 }
+
+TEST_F(ScreensModelTest, ScreenGeometriesFollowUpdates)
+{
+    std::vector<mg::DisplayConfigurationOutput> config{fakeOutput1, fakeOutput2};
+    std::vector<MockGLDisplayBuffer*> bufferConfig; // only used to match buffer with display, unecessary here
+    display->setFakeConfiguration(config, bufferConfig);
+
+    EXPECT_TRUE(screensModel->screenGeometries().isEmpty());
+
+    screensModel->update();
+
+    auto screenGeometries = screensModel->screenGeometries();
+    ASSERT_EQ(2, screenGeometries.count());
+    EXPECT_EQ(QRect(0, 0, 150, 200), screenGeometries[0].geometry);
+    EXPECT_EQ(QRect(500, 600, 1500, 2000), screenGeometries[1].geometry);
+    for (int i = 0; i < screenGeometries.count(); ++i) {
+        EXPECT_EQ(screensModel->screens().at(i)->cursor(), screenGeometries[i].cursor.data());
+    }
+
+    config.pop_back();
+    display->setFakeConfiguration(config, bufferConfig);
+    screensModel->update();
+
+    ASSERT_EQ(1, screensModel->screenGeometries().count());
+    EXPECT_EQ(QRect(0, 0, 150, 200), screensModel->screenGeometries()[0].geometry);
+
+    // Whoever still holds an older snapshot can keep using its cursors
+    EXPECT_EQ(2, screenGeometries.count());
+    EXPECT_FALSE(screenGeometries[1].cursor.isNull());
+}
+
+TEST_F(ScreensModelTest, CursorsLiveInTheGuiThreadWhenUpdatedFromAnotherThread)
+{
+    std::vector<mg::DisplayConfigurationOutput> config{fakeOutput1, fakeOutput2};
+    std::vector<MockGLDisplayBuffer*> bufferConfig; // only used to match buffer with display, unecessary here
+    display->setFakeConfiguration(config, bufferConfig);
+
+    // Like the Mir server thread does on start and on output changes
+    std::thread mirServerThread([this]() { screensModel->update(); });
+    mirServerThread.join();
+
+    auto screenGeometries = screensModel->screenGeometries();
+    ASSERT_EQ(2, screenGeometries.count());
+    for (int i = 0; i < screenGeometries.count(); ++i) {
+        ASSERT_FALSE(screenGeometries[i].cursor.isNull());
+        EXPECT_EQ(qApp->thread(), screenGeometries[i].cursor->thread());
+        EXPECT_EQ(screensModel->screens().at(i)->cursor(), screenGeometries[i].cursor.data());
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <surfaceobserver.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+class FakeSurfaceObserver : public SurfaceObserver
+{
+public:
+#if MIR_SERVER_VERSION >= MIR_VERSION_NUMBER(0, 30, 0)
+    void frame_posted(mir::scene::Surface const*, int, mir::geometry::Size const&) override {}
+#else
+    void frame_posted(int, mir::geometry::Size const&) override {}
+#endif
+};
+
+// The registry only uses surfaces as keys, so any suitably aligned address stands in for one
+struct alignas(16) FakeSurface { char storage[256]; };
+
+const mir::scene::Surface *asSurface(const FakeSurface &fakeSurface)
+{
+    return reinterpret_cast<const mir::scene::Surface*>(&fakeSurface);
+}
+
+} // anonymous namespace
+
+TEST(SurfaceObserverTest, registeredObserversAreFoundUntilDestroyed)
+{
+    const int count = 256;
+    std::vector<FakeSurface> surfaces(count);
+    std::vector<std::unique_ptr<FakeSurfaceObserver>> observers;
+    for (int i = 0; i < count; ++i) {
+        observers.emplace_back(new FakeSurfaceObserver);
+        SurfaceObserver::registerObserverForSurface(observers[i].get(), asSurface(surfaces[i]));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(observers[i].get(), SurfaceObserver::observerForSurface(asSurface(surfaces[i])));
+    }
+
+    // Destroy every other observer
+    for (int i = 0; i < count; i += 2) {
+        observers[i].reset();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(observers[i].get(), SurfaceObserver::observerForSurface(asSurface(surfaces[i])));
+    }
+
+    observers.clear();
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(nullptr, SurfaceObserver::observerForSurface(asSurface(surfaces[i])));
+    }
+}
+
+TEST(SurfaceObserverTest, destroyingAReplacedObserverLeavesItsReplacementRegistered)
+{
+    FakeSurface surface;
+    std::unique_ptr<FakeSurfaceObserver> oldObserver(new FakeSurfaceObserver);
+    FakeSurfaceObserver newObserver;
+
+    SurfaceObserver::registerObserverForSurface(oldObserver.get(), asSurface(surface));
+    SurfaceObserver::registerObserverForSurface(&newObserver, asSurface(surface));
+    oldObserver.reset();
+
+    EXPECT_EQ(&newObserver, SurfaceObserver::observerForSurface(asSurface(surface)));
+}
+
+TEST(SurfaceObserverTest, unregisteredSurfaceHasNoObserver)
+{
+    FakeSurface surface;
+    EXPECT_EQ(nullptr, SurfaceObserver::observerForSurface(asSurface(surface)));
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <touchrouter.h>
+
+#include "mir/events/event_builders.h"
+
+// mirtest
+#include <mir/test/doubles/stub_session.h>
+#include <mir/test/doubles/stub_surface.h>
+
+#include <vector>
+
+using namespace qtmir;
+
+namespace mev = mir::events;
+
+using StubSurface = mir::test::doubles::StubSurface;
+using StubSession = mir::test::doubles::StubSession;
+
+namespace {
+
+struct Touch {
+    int id;
+    MirTouchAction action;
+    float x;
+    float y;
+};
+
+} // anonymous namespace
+
+class TouchRouterTest : public ::testing::Test
+{
+protected:
+    TouchRouterTest()
+        : window(std::make_shared<StubSession>(), std::make_shared<StubSurface>())
+        , otherWindow(std::make_shared<StubSession>(), std::make_shared<StubSurface>())
+    {
+    }
+
+    miral::Window route(const std::vector<Touch> &touches)
+    {
+        auto ev = mev::make_event(MirInputDeviceId(), std::chrono::milliseconds(123), std::vector<uint8_t>{} /* cookie */, 0);
+        for (const auto &touch : touches) {
+            mev::add_touch(*ev, touch.id, touch.action, mir_touch_tooltype_finger,
+                           touch.x, touch.y, 10 /* pressure */,
+                           1, 1, 10 /* touch major, minor, size */);
+        }
+        return router.route(mir_input_event_get_touch_event(mir_event_get_input_event(ev.get())));
+    }
+
+    void enableDirectInput()
+    {
+        router.setDirectInputWindow(window, true);
+        router.setDirectInputAllowed(true);
+    }
+
+    TouchRouter router;
+    miral::Window window;
+    miral::Window otherWindow;
+};
+
+TEST_F(TouchRouterTest, goesThroughQtWithoutDirectInputWindow)
+{
+    router.setDirectInputAllowed(true);
+
+    EXPECT_FALSE(route({{0, mir_touch_action_down, 100, 100}}));
+}
+
+TEST_F(TouchRouterTest, goesThroughQtUnlessShellAllowsDirectInput)
+{
+    router.setDirectInputWindow(window, true);
+
+    EXPECT_FALSE(route({{0, mir_touch_action_down, 100, 100}}));
+}
+
+TEST_F(TouchRouterTest, wholeSequenceGoesDirectly)
+{
+    enableDirectInput();
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 100, 100}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_change, 110, 100}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_change, 110, 100}, {1, mir_touch_action_down, 200, 200}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_change, 110, 100}, {1, mir_touch_action_up, 200, 200}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_up, 110, 100}}));
+}
+
+TEST_F(TouchRouterTest, sequenceStartingInShellGestureRegionGoesThroughQt)
+{
+    enableDirectInput();
+    router.setShellGestureRegions({QRect(0, 0, 10, 1000)});
+
+    EXPECT_FALSE(route({{0, mir_touch_action_down, 5, 100}}));
+
+    // Dragging out of the region doesn't hand the sequence over to the client
+    EXPECT_FALSE(route({{0, mir_touch_action_change, 300, 100}}));
+    EXPECT_FALSE(route({{0, mir_touch_action_up, 300, 100}}));
+
+    // The next sequence is decided afresh
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 300, 100}}));
+}
+
+TEST_F(TouchRouterTest, touchEnteringShellGestureRegionMidSequenceStaysDirect)
+{
+    enableDirectInput();
+    router.setShellGestureRegions({QRect(0, 0, 10, 1000)});
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 300, 100}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_change, 300, 100}, {1, mir_touch_action_down, 5, 100}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_change, 5, 100}, {1, mir_touch_action_change, 5, 100}}));
+}
+
+TEST_F(TouchRouterTest, anyTouchInShellGestureRegionSendsSequenceThroughQt)
+{
+    enableDirectInput();
+    router.setShellGestureRegions({QRect(0, 0, 10, 1000)});
+
+    EXPECT_FALSE(route({{0, mir_touch_action_down, 300, 100}, {1, mir_touch_action_down, 5, 100}}));
+}
+
+TEST_F(TouchRouterTest, disallowingDirectInputOnlyAffectsNextSequence)
+{
+    enableDirectInput();
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 100, 100}}));
+
+    router.setDirectInputAllowed(false);
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_change, 110, 100}}));
+    EXPECT_EQ(window, route({{0, mir_touch_action_up, 110, 100}}));
+
+    EXPECT_FALSE(route({{0, mir_touch_action_down, 100, 100}}));
+    EXPECT_FALSE(route({{0, mir_touch_action_up, 100, 100}}));
+
+    router.setDirectInputAllowed(true);
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 100, 100}}));
+}
+
+TEST_F(TouchRouterTest, sequenceKeepsTheWindowItStartedOn)
+{
+    enableDirectInput();
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 100, 100}}));
+
+    router.setDirectInputWindow(otherWindow, true);
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_up, 100, 100}}));
+    EXPECT_EQ(otherWindow, route({{0, mir_touch_action_down, 100, 100}}));
+}
+
+TEST_F(TouchRouterTest, disablingAnotherWindowKeepsDirectInputWindow)
+{
+    enableDirectInput();
+    router.setDirectInputWindow(otherWindow, false);
+
+    EXPECT_EQ(window, route({{0, mir_touch_action_down, 100, 100}}));
+}
+
+TEST_F(TouchRouterTest, disablingDirectInputWindowSendsNextSequenceThroughQt)
+{
+    enableDirectInput();
+    router.setDirectInputWindow(window, false);
+
+    EXPECT_FALSE(route({{0, mir_touch_action_down, 100, 100}}));
+}
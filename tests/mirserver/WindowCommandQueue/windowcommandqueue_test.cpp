@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <windowcommandqueue.h>
+
+// mirtest
+#include <mir/test/doubles/stub_session.h>
+#include <mir/test/doubles/stub_surface.h>
+
+#include <QCoreApplication>
+
+#include <vector>
+
+using namespace qtmir;
+
+using StubSurface = mir::test::doubles::StubSurface;
+using StubSession = mir::test::doubles::StubSession;
+
+class WindowCommandQueueTest : public ::testing::Test
+{
+protected:
+    WindowCommandQueueTest()
+        : window(std::make_shared<StubSession>(), std::make_shared<StubSurface>())
+        , otherWindow(std::make_shared<StubSession>(), std::make_shared<StubSurface>())
+        , queue([this](QVector<WindowCommand> &commands) {
+            batches.push_back(commands);
+            for (auto &command : commands) {
+                command.applied = command.window != goneWindow;
+            }
+        })
+    {
+    }
+
+    static WindowCommand command(WindowCommand::Type type, const miral::Window &window)
+    {
+        return {type, window, {}, {}, Mir::UnknownState};
+    }
+
+    static std::vector<WindowCommand::Type> types(const QVector<WindowCommand> &commands)
+    {
+        std::vector<WindowCommand::Type> result;
+        for (const auto &command : commands) {
+            result.push_back(command.type);
+        }
+        return result;
+    }
+
+    int argc{0};
+    QCoreApplication app{argc, nullptr};
+
+    miral::Window window;
+    miral::Window otherWindow;
+    miral::Window goneWindow;
+
+    std::vector<QVector<WindowCommand>> batches;
+    WindowCommandQueue queue;
+};
+
+TEST_F(WindowCommandQueueTest, appliesQueuedCommandsInOneBatchOnceBackInTheEventLoop)
+{
+    queue.enqueue(command(WindowCommand::RequestState, window));
+    queue.enqueue(command(WindowCommand::Activate, window));
+    queue.enqueue(command(WindowCommand::Raise, otherWindow));
+    EXPECT_TRUE(batches.empty());
+
+    QCoreApplication::processEvents();
+
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ(std::vector<WindowCommand::Type>({WindowCommand::RequestState, WindowCommand::Activate, WindowCommand::Raise}),
+              types(batches[0]));
+    EXPECT_EQ(otherWindow, batches[0][2].window);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(WindowCommandQueueTest, flushAppliesQueuedCommandsRightAwayAndOnlyOnce)
+{
+    queue.enqueue(command(WindowCommand::Activate, window));
+    queue.enqueue(command(WindowCommand::Raise, window));
+
+    queue.flush();
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ(2, batches[0].count());
+
+    QCoreApplication::processEvents();
+    EXPECT_EQ(1u, batches.size());
+}
+
+TEST_F(WindowCommandQueueTest, flushWithNothingQueuedAppliesNothing)
+{
+    // As done before delivering each input event, which must not take the WM lock for nothing
+    queue.flush();
+    QCoreApplication::processEvents();
+
+    EXPECT_TRUE(batches.empty());
+}
+
+TEST_F(WindowCommandQueueTest, closeFollowsCommandsQueuedBeforeIt)
+{
+    // What WindowController does for requestClose()
+    queue.enqueue(command(WindowCommand::Activate, otherWindow));
+    queue.enqueue(command(WindowCommand::RequestClose, window));
+    queue.flush();
+
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ(std::vector<WindowCommand::Type>({WindowCommand::Activate, WindowCommand::RequestClose}),
+              types(batches[0]));
+}
+
+TEST_F(WindowCommandQueueTest, commandsQueuedAfterAFlushGoInTheNextBatch)
+{
+    queue.enqueue(command(WindowCommand::Activate, window));
+    queue.flush();
+    queue.enqueue(command(WindowCommand::Raise, otherWindow));
+
+    QCoreApplication::processEvents();
+
+    ASSERT_EQ(2u, batches.size());
+    EXPECT_EQ(std::vector<WindowCommand::Type>({WindowCommand::Raise}), types(batches[1]));
+}
+
+TEST_F(WindowCommandQueueTest, resultHandlerIsToldWhetherEachCommandWasApplied)
+{
+    std::vector<std::pair<WindowCommand::Type, bool>> results;
+    queue.setResultHandler([&results](const WindowCommand &command) {
+        results.emplace_back(command.type, command.applied);
+    });
+
+    queue.enqueue(command(WindowCommand::Activate, window));
+    queue.enqueue(command(WindowCommand::Raise, goneWindow));
+    queue.enqueue(command(WindowCommand::Move, otherWindow));
+    queue.flush();
+
+    EXPECT_EQ((std::vector<std::pair<WindowCommand::Type, bool>>{
+                  {WindowCommand::Activate, true}, {WindowCommand::Raise, false}, {WindowCommand::Move, true}}),
+              results);
+}
+
+TEST(ApplyWindowCommandsTest, appliesInOrderAndSkipsCommandsForWindowsThatAreGone)
+{
+    const miral::Window window(std::make_shared<StubSession>(), std::make_shared<StubSurface>());
+    const miral::Window goneWindow(std::make_shared<StubSession>(), std::make_shared<StubSurface>());
+
+    QVector<WindowCommand> commands{
+        {WindowCommand::Resize, window, QSize(10, 20), {}, Mir::UnknownState},
+        {WindowCommand::Move, goneWindow, {}, QPoint(1, 2), Mir::UnknownState},
+        {WindowCommand::RequestState, window, {}, {}, Mir::MaximizedState},
+    };
+
+    std::vector<WindowCommand::Type> appliedInOrder;
+    applyWindowCommands(commands, [&](const WindowCommand &command) {
+        if (command.window == goneWindow) {
+            throw std::out_of_range("window gone");
+        }
+        appliedInOrder.push_back(command.type);
+    });
+
+    EXPECT_EQ(std::vector<WindowCommand::Type>({WindowCommand::Resize, WindowCommand::RequestState}), appliedInOrder);
+    EXPECT_TRUE(commands[0].applied);
+    EXPECT_FALSE(commands[1].applied);
+    EXPECT_TRUE(commands[2].applied);
+}
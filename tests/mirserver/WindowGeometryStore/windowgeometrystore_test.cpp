@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <windowgeometrystore.h>
+
+#include <QDir>
+#include <QStandardPaths>
+
+class WindowGeometryStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        // Keep away from the real cache directory
+        QStandardPaths::setTestModeEnabled(true);
+        QDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/qtmir").removeRecursively();
+        WindowGeometryStore::load();
+    }
+
+    void TearDown() override
+    {
+        WindowGeometryStore::removeAppId(pid);
+    }
+
+    const pid_t pid{1234};
+};
+
+TEST_F(WindowGeometryStoreTest, geometryIsRememberedAcrossSaveAndLoad)
+{
+    WindowGeometryStore::setAppId(pid, "gedit");
+
+    WindowGeometryStore::Geometry geometry;
+    geometry.size = QSize(640, 480);
+    geometry.state = Mir::RestoredState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+    WindowGeometryStore::save();
+
+    WindowGeometryStore::load();
+
+    auto found = WindowGeometryStore::find(pid, "Untitled");
+    EXPECT_EQ(QSize(640, 480), found.size);
+    EXPECT_EQ(Mir::RestoredState, found.state);
+
+    EXPECT_FALSE(WindowGeometryStore::find(pid, "Preferences").isValid());
+}
+
+TEST_F(WindowGeometryStoreTest, restoredSizeOfMaximizedWindowIsRemembered)
+{
+    WindowGeometryStore::setAppId(pid, "gedit");
+
+    WindowGeometryStore::Geometry geometry;
+    geometry.size = QSize(640, 480);
+    geometry.state = Mir::RestoredState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+
+    // Maximized, with a restore size of its own
+    geometry.size = QSize(800, 600);
+    geometry.state = Mir::MaximizedState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+
+    auto found = WindowGeometryStore::find(pid, "Untitled");
+    EXPECT_EQ(QSize(800, 600), found.size);
+    EXPECT_EQ(Mir::MaximizedState, found.state);
+}
+
+TEST_F(WindowGeometryStoreTest, lastKnownSizeIsKeptWhenNoneIsRecorded)
+{
+    WindowGeometryStore::setAppId(pid, "gedit");
+
+    WindowGeometryStore::Geometry geometry;
+    geometry.size = QSize(640, 480);
+    geometry.state = Mir::RestoredState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+
+    // Fullscreen, without a known restore size
+    geometry.size = QSize();
+    geometry.state = Mir::FullscreenState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+
+    auto found = WindowGeometryStore::find(pid, "Untitled");
+    EXPECT_EQ(QSize(640, 480), found.size);
+    EXPECT_EQ(Mir::FullscreenState, found.state);
+}
+
+TEST_F(WindowGeometryStoreTest, changesAfterSaveAreNotWritten)
+{
+    WindowGeometryStore::setAppId(pid, "gedit");
+
+    WindowGeometryStore::Geometry geometry;
+    geometry.size = QSize(640, 480);
+    geometry.state = Mir::RestoredState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+    WindowGeometryStore::save();
+
+    // Recorded while the save may still be in progress
+    geometry.size = QSize(800, 600);
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+
+    WindowGeometryStore::load();
+
+    EXPECT_EQ(QSize(640, 480), WindowGeometryStore::find(pid, "Untitled").size);
+}
+
+TEST_F(WindowGeometryStoreTest, unknownProcessesAreNotRemembered)
+{
+    WindowGeometryStore::Geometry geometry;
+    geometry.size = QSize(640, 480);
+    geometry.state = Mir::RestoredState;
+    WindowGeometryStore::record(pid, "Untitled", geometry);
+
+    WindowGeometryStore::setAppId(pid, "gedit");
+    EXPECT_FALSE(WindowGeometryStore::find(pid, "Untitled").isValid());
+}
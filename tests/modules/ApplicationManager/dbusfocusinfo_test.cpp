@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <Unity/Application/dbusfocusinfo.h>
+
+using namespace qtmir;
+
+TEST(DBusFocusInfoTest, applicationCgroupOfUpstartJob)
+{
+    const QByteArray cgroup =
+        "11:freezer:/user.slice/user-32011.slice/session-c3.scope/upstart/application-legacy-puritine_gedit_0.0-\n"
+        "10:memory:/user.slice\n"
+        "1:name=systemd:/user.slice/user-32011.slice/session-c3.scope\n";
+
+    EXPECT_EQ(QString("/user.slice/user-32011.slice/session-c3.scope/upstart/application-legacy-puritine_gedit_0.0-"),
+              DBusFocusInfo::applicationCgroup(cgroup));
+}
+
+TEST(DBusFocusInfoTest, applicationCgroupOfSystemdScopeInUnifiedHierarchy)
+{
+    const QByteArray cgroup =
+        "0::/user.slice/user-1000.slice/user@1000.service/app.slice/app-gnome-org.gnome.gedit-2345.scope\n";
+
+    EXPECT_EQ(QString("/user.slice/user-1000.slice/user@1000.service/app.slice/app-gnome-org.gnome.gedit-2345.scope"),
+              DBusFocusInfo::applicationCgroup(cgroup));
+}
+
+TEST(DBusFocusInfoTest, applicationCgroupOfUbuntuAppLaunchService)
+{
+    const QByteArray cgroup =
+        "0::/user.slice/user-1000.slice/user@1000.service/ubuntu-app-launch--application-legacy--gedit--.service\n";
+
+    EXPECT_EQ(QString("/user.slice/user-1000.slice/user@1000.service/ubuntu-app-launch--application-legacy--gedit--.service"),
+              DBusFocusInfo::applicationCgroup(cgroup));
+}
+
+TEST(DBusFocusInfoTest, applicationCgroupOfSystemdUnitInHybridHierarchy)
+{
+    // Freezer hierarchy present, but the application was not started by upstart
+    const QByteArray cgroup =
+        "11:freezer:/\n"
+        "1:name=systemd:/user.slice/user-1000.slice/user@1000.service/app.slice/app-gedit-1234.scope\n"
+        "0::/user.slice/user-1000.slice/user@1000.service/app.slice/app-gedit-1234.scope\n";
+
+    EXPECT_EQ(QString("/user.slice/user-1000.slice/user@1000.service/app.slice/app-gedit-1234.scope"),
+              DBusFocusInfo::applicationCgroup(cgroup));
+}
+
+TEST(DBusFocusInfoTest, noApplicationCgroupOutsideAnApplicationUnit)
+{
+    // Shared by whatever else runs in the login session, or in the app slice
+    EXPECT_TRUE(DBusFocusInfo::applicationCgroup("0::/user.slice/user-1000.slice/session-2.scope\n").isNull());
+    EXPECT_TRUE(DBusFocusInfo::applicationCgroup("0::/user.slice/user-1000.slice/user@1000.service/app.slice\n").isNull());
+    EXPECT_TRUE(DBusFocusInfo::applicationCgroup("11:freezer:/\n1:name=systemd:/user.slice\n").isNull());
+}
+
+TEST(DBusFocusInfoTest, noApplicationCgroupInUnreadableContents)
+{
+    EXPECT_TRUE(DBusFocusInfo::applicationCgroup(QByteArray()).isNull());
+    EXPECT_TRUE(DBusFocusInfo::applicationCgroup("garbage\n").isNull());
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <Unity/Application/desktopfileindex.h>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+using namespace qtmir;
+
+namespace {
+void writeDesktopFile(const QString &path, const QByteArray &exec)
+{
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("[Desktop Entry]\nType=Application\nName=Test\nExec=" + exec + "\n"
+               "[Desktop Action New]\nExec=something-else\n");
+}
+}
+
+class DesktopFileIndexTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        ASSERT_TRUE(applicationsDir.isValid());
+    }
+
+    int argc{0};
+    char **argv{nullptr};
+    QCoreApplication qtApp{argc, argv};
+    QTemporaryDir applicationsDir;
+};
+
+TEST_F(DesktopFileIndexTest, findsDesktopFileByExecFileName)
+{
+    const QString geditDesktopFile = applicationsDir.path() + "/gedit.desktop";
+    writeDesktopFile(geditDesktopFile, "env LANG=C /usr/bin/gedit --new-window %U");
+
+    DesktopFileIndex index(QStringList() << applicationsDir.path());
+    QSignalSpy updatedSpy(&index, &DesktopFileIndex::updated);
+    ASSERT_TRUE(updatedSpy.count() > 0 || updatedSpy.wait());
+
+    EXPECT_EQ(geditDesktopFile, index.desktopFileForExec("gedit"));
+    EXPECT_EQ(geditDesktopFile, index.desktopFileForExec("/usr/local/bin/gedit"));
+    EXPECT_TRUE(index.desktopFileForExec("something-else").isNull());
+    EXPECT_TRUE(index.desktopFileForExec("env").isNull());
+}
+
+TEST_F(DesktopFileIndexTest, picksUpNewlyInstalledDesktopFiles)
+{
+    DesktopFileIndex index(QStringList() << applicationsDir.path());
+    QSignalSpy updatedSpy(&index, &DesktopFileIndex::updated);
+    ASSERT_TRUE(updatedSpy.count() > 0 || updatedSpy.wait());
+    EXPECT_TRUE(index.desktopFileForExec("gedit").isNull());
+
+    const QString geditDesktopFile = applicationsDir.path() + "/gedit.desktop";
+    writeDesktopFile(geditDesktopFile, "gedit");
+
+    updatedSpy.clear();
+    ASSERT_TRUE(updatedSpy.wait());
+    EXPECT_EQ(geditDesktopFile, index.desktopFileForExec("gedit"));
+}
+
+TEST_F(DesktopFileIndexTest, indexOfNoDirectoriesStaysEmpty)
+{
+    DesktopFileIndex index(QStringList{});
+    QSignalSpy updatedSpy(&index, &DesktopFileIndex::updated);
+
+    EXPECT_FALSE(updatedSpy.wait(100));
+    EXPECT_TRUE(index.desktopFileForExec("gedit").isNull());
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2017 Canonical, Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3, as published by
+ * the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranties of MERCHANTABILITY,
+ * SATISFACTORY QUALITY, or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <Unity/Application/proc_info.h>
+
+#include <unistd.h>
+
+using namespace qtmir;
+
+TEST(ProcInfoTest, commandLineIsSplitIntoArguments)
+{
+    const char cmdline[] = "/usr/bin/app\0--desktop_file_hint=/usr/share/applications/app.desktop\0some file\0";
+    ProcInfo::CommandLine commandLine(QByteArray(cmdline, sizeof(cmdline) - 1));
+
+    EXPECT_EQ(QStringList({"/usr/bin/app", "--desktop_file_hint=/usr/share/applications/app.desktop", "some file"}),
+              commandLine.asStringList());
+    EXPECT_EQ(QString("/usr/bin/app"), commandLine.getExec());
+    EXPECT_EQ(QString("/usr/share/applications/app.desktop"), commandLine.getParameter("--desktop_file_hint="));
+    EXPECT_TRUE(commandLine.getParameter("--missing=").isNull());
+    EXPECT_TRUE(commandLine.startsWith("/usr/bin/app"));
+}
+
+TEST(ProcInfoTest, environmentIsSplitIntoVariables)
+{
+    const char variables[] = "HOME=/home/user\0DESKTOP_FILE_HINT=app.desktop\0EMPTY=\0";
+    ProcInfo::Environment environment(QByteArray(variables, sizeof(variables) - 1));
+
+    EXPECT_TRUE(environment.contains("DESKTOP_FILE_HINT"));
+    EXPECT_EQ(QString("app.desktop"), environment.getParameter("DESKTOP_FILE_HINT"));
+    EXPECT_TRUE(environment.contains("EMPTY"));
+    EXPECT_FALSE(environment.contains("DESKTOP_FILE"));
+}
+
+TEST(ProcInfoTest, readsOwnProcess)
+{
+    ProcInfo procInfo;
+
+    auto commandLine = procInfo.commandLine(getpid());
+    ASSERT_TRUE(commandLine != nullptr);
+    EXPECT_FALSE(commandLine->getExec().isEmpty());
+
+    // Answered from what was read the first time
+    auto again = procInfo.commandLine(getpid());
+    ASSERT_TRUE(again != nullptr);
+    EXPECT_EQ(commandLine->asStringList(), again->asStringList());
+}
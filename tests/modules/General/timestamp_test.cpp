@@ -22,6 +22,9 @@
 #include <QCoreApplication>
 #include <QDebug>
 
+#include <thread>
+#include <vector>
+
 using namespace qtmir;
 
 class TimestampTest: public ::testing::Test
@@ -76,3 +79,27 @@ TEST_F(TimestampTest, TestOverflowWhenExceeding32bitCompression)
     // ensure the uncompression will yields the original timestamp
     EXPECT_EQ(qtmir::uncompressTimestamp<Timestamp32bit>(compressedTimestamp), timestamp);
 }
+
+TEST_F(TimestampTest, StartTimeIsSetOnlyOnceByConcurrentCallers)
+{
+    using namespace testing;
+
+    const int threadCount = 8;
+    std::vector<std::chrono::nanoseconds> startTimes(threadCount);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back([&startTimes, i]() {
+            startTimes[i] = getStartTime(std::chrono::seconds(1000) + std::chrono::milliseconds(i));
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Whoever got there first sets the epoch, all others must see it
+    for (int i = 0; i < threadCount; i++) {
+        EXPECT_EQ(startTimes[0], startTimes[i]);
+    }
+    EXPECT_EQ(startTimes[0], getStartTime(std::chrono::seconds(2000)));
+}
@@ -16,6 +16,7 @@
 
 #include <QLoggingCategory>
 #include <QSignalSpy>
+#include <QStringList>
 
 // the test subject
 #include <Unity/Application/surfacemanager.h>
@@ -132,6 +133,133 @@ TEST_F(SurfaceManagerTests, miralWindowCreationAddsMirSurfaceToItsInternalList)
     EXPECT_EQ(window, mirSurface->window());
 }
 
+/*
+ * Test that changes MirAL makes in one transaction are applied together, between the
+ * modificationsStarted and modificationsEnded signals
+ */
+TEST_F(SurfaceManagerTests, miralTransactionIsAppliedBetweenModificationSignals)
+{
+    QSignalSpy modificationsStartedSpy(surfaceManager.data(), &SurfaceManager::modificationsStarted);
+    QSignalSpy modificationsEndedSpy(surfaceManager.data(), &SurfaceManager::modificationsEnded);
+    bool surfaceCreatedDuringModifications = false;
+    QObject::connect(surfaceManager.data(), &SurfaceManager::surfaceCreated, [&]() {
+        surfaceCreatedDuringModifications = modificationsStartedSpy.count() == 1
+                                         && modificationsEndedSpy.count() == 0;
+    });
+
+    // Test
+    wmNotifier.beginChanges();
+    wmNotifier.notifyWindowAdded(windowInfo);
+    wmNotifier.notifyWindowMoved(windowInfo, QPoint(10, 20));
+    wmNotifier.endChanges();
+    qtApp->sendPostedEvents();
+
+    // Check result
+    EXPECT_TRUE(surfaceCreatedDuringModifications);
+    EXPECT_EQ(1, modificationsEndedSpy.count());
+    auto mirSurface = surfaceManager->find(windowInfo);
+    ASSERT_TRUE(mirSurface);
+    EXPECT_EQ(QPoint(10, 20), mirSurface->position());
+}
+
+/*
+ * Test that moves MirAL makes before the Qt side catches up are coalesced, so the MirSurface
+ * only sees the last position
+ */
+TEST_F(SurfaceManagerTests, miralMovesNotYetDeliveredAreCoalesced)
+{
+    // Setup: add window and get corresponding MirSurface
+    Q_EMIT wmNotifier.windowAdded(windowInfo);
+    qtApp->sendPostedEvents();
+    auto mirSurface = surfaceManager->find(windowInfo);
+    ASSERT_TRUE(mirSurface);
+
+    QSignalSpy mirSurfacePositionSpy(mirSurface, &qtmir::MirSurface::positionChanged);
+
+    // Test
+    for (int i = 1; i <= 3; i++) {
+        wmNotifier.beginChanges();
+        wmNotifier.notifyWindowMoved(windowInfo, QPoint(i, i));
+        wmNotifier.endChanges();
+    }
+    qtApp->sendPostedEvents();
+
+    // Check result
+    EXPECT_EQ(1, mirSurfacePositionSpy.count());
+    EXPECT_EQ(QPoint(3, 3), mirSurface->position());
+}
+
+/*
+ * Test that a move is not coalesced with one MirAL made before another queued signal, so the
+ * MirSurface sees the changes in the order MirAL made them
+ */
+TEST_F(SurfaceManagerTests, miralMovesAreNotCoalescedAcrossAnotherQueuedSignal)
+{
+    // Setup: add window and get corresponding MirSurface
+    Q_EMIT wmNotifier.windowAdded(windowInfo);
+    qtApp->sendPostedEvents();
+    auto mirSurface = surfaceManager->find(windowInfo);
+    ASSERT_TRUE(mirSurface);
+
+    QStringList log;
+    QObject::connect(mirSurface, &qtmir::MirSurface::positionChanged, [&]() {
+        log << QStringLiteral("moved to %1,%2").arg(mirSurface->position().x()).arg(mirSurface->position().y());
+    });
+    QObject::connect(mirSurface, &qtmir::MirSurface::focusedChanged, [&]() {
+        log << QStringLiteral("focused");
+    });
+
+    // Test
+    wmNotifier.beginChanges();
+    wmNotifier.notifyWindowMoved(windowInfo, QPoint(1, 1));
+    wmNotifier.endChanges();
+    wmNotifier.notifyWindowFocusChanged(windowInfo, true);
+    wmNotifier.beginChanges();
+    wmNotifier.notifyWindowMoved(windowInfo, QPoint(2, 2));
+    wmNotifier.endChanges();
+    qtApp->sendPostedEvents();
+
+    // Check result
+    EXPECT_EQ(QStringList({"moved to 1,1", "focused", "moved to 2,2"}), log);
+}
+
+/*
+ * Test that a transaction with more than moves and resizes is not merged into one the Qt side
+ * has not caught up with, while a later transaction of only moves is merged into it
+ */
+TEST_F(SurfaceManagerTests, miralTransactionWithOtherChangesIsNotCoalesced)
+{
+    // Setup: add window and get corresponding MirSurface
+    Q_EMIT wmNotifier.windowAdded(windowInfo);
+    qtApp->sendPostedEvents();
+    auto mirSurface = surfaceManager->find(windowInfo);
+    ASSERT_TRUE(mirSurface);
+
+    QStringList log;
+    QObject::connect(mirSurface, &qtmir::MirSurface::positionChanged, [&]() {
+        log << QStringLiteral("moved to %1,%2").arg(mirSurface->position().x()).arg(mirSurface->position().y());
+    });
+    QObject::connect(mirSurface, &qtmir::MirSurface::stateChanged, [&]() {
+        log << QStringLiteral("state changed");
+    });
+
+    // Test
+    wmNotifier.beginChanges();
+    wmNotifier.notifyWindowMoved(windowInfo, QPoint(1, 1));
+    wmNotifier.endChanges();
+    wmNotifier.beginChanges();
+    wmNotifier.notifyWindowStateChanged(windowInfo, Mir::MaximizedState);
+    wmNotifier.notifyWindowMoved(windowInfo, QPoint(2, 2));
+    wmNotifier.endChanges();
+    wmNotifier.beginChanges();
+    wmNotifier.notifyWindowMoved(windowInfo, QPoint(3, 3));
+    wmNotifier.endChanges();
+    qtApp->sendPostedEvents();
+
+    // Check result
+    EXPECT_EQ(QStringList({"moved to 1,1", "state changed", "moved to 3,3"}), log);
+}
+
 /*
  * Test SurfaceManager creates a MirSurface with a Session associated
  */
@@ -340,6 +468,32 @@ TEST_F(SurfaceManagerTests, miralsRaiseWindowListTransformedToVectorOfMirSurface
     EXPECT_EQ(mirSurface2, raiseMirSurfaceList.at(0));
 }
 
+/*
+ * Test that MirAL notifying the start and end of a client-requested move or resize reaches the
+ * corresponding MirSurface
+ */
+TEST_F(SurfaceManagerTests, miralMoveResizeStartAndEndReachMirSurface)
+{
+    // Setup: add window and get corresponding MirSurface
+    Q_EMIT wmNotifier.windowAdded(windowInfo);
+    qtApp->sendPostedEvents();
+    auto mirSurface = surfaceManager->find(windowInfo);
+    ASSERT_TRUE(mirSurface);
+
+    QSignalSpy moveResizeStartedSpy(mirSurface, &qtmir::MirSurface::moveResizeStarted);
+    QSignalSpy moveResizeEndedSpy(mirSurface, &qtmir::MirSurface::moveResizeEnded);
+
+    // Test
+    Q_EMIT wmNotifier.windowMoveResizeStarted(windowInfo);
+    qtApp->sendPostedEvents();
+    EXPECT_EQ(1, moveResizeStartedSpy.count());
+    EXPECT_EQ(0, moveResizeEndedSpy.count());
+
+    Q_EMIT wmNotifier.windowMoveResizeEnded(windowInfo);
+    qtApp->sendPostedEvents();
+    EXPECT_EQ(1, moveResizeEndedSpy.count());
+}
+
 /*
  * Test focus requests fire focusRequested signal of the MirSurface
  */
@@ -385,6 +539,34 @@ TEST_F(SurfaceManagerTests, miralWindowRemovedDeletesSurfaceManagerInternalEntry
     EXPECT_FALSE(surfaceManager->find(windowInfo));
 }
 
+/*
+ * Test that removing a window only drops its own entry, even if another window wraps
+ * the same mir::scene::Surface
+ */
+TEST_F(SurfaceManagerTests, miralWindowRemovedLeavesOtherWindowsOnSameSceneSurfaceFindable)
+{
+    // Setup
+    miral::Window window1(stubSession, stubSurface);
+    miral::Window window2(stubSession, stubSurface);
+    miral::WindowInfo windowInfo1(window1, spec);
+    miral::WindowInfo windowInfo2(window2, spec);
+
+    Q_EMIT wmNotifier.windowAdded(windowInfo1);
+    Q_EMIT wmNotifier.windowAdded(windowInfo2);
+    qtApp->sendPostedEvents();
+    auto mirSurface2 = surfaceManager->find(windowInfo2);
+    ASSERT_TRUE(surfaceManager->find(windowInfo1));
+    ASSERT_TRUE(mirSurface2);
+
+    // Test
+    Q_EMIT wmNotifier.windowRemoved(windowInfo1);
+    qtApp->sendPostedEvents();
+
+    // Check result
+    EXPECT_FALSE(surfaceManager->find(windowInfo1));
+    EXPECT_EQ(mirSurface2, surfaceManager->find(windowInfo2));
+}
+
 /*
  * If MirAL notifies that a window was removed, and its corresponding MirSurface *is*
  * being displayed, test that SurfaceManager removes the corresponding MirSurface from
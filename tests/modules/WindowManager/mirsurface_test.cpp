@@ -52,6 +52,7 @@ struct MirEvent {}; // otherwise won't compile otherwise due to incomplete type
 // miral
 #include <miral/window.h>
 #include <miral/window_info.h>
+#include <miral/window_specification.h>
 
 using namespace qtmir;
 
@@ -67,6 +68,8 @@ struct MockSurface : public StubSurface
     MOCK_CONST_METHOD0(visible, bool());
     MOCK_CONST_METHOD0(state, MirWindowState());
     MOCK_CONST_METHOD1(generate_renderables,mir::graphics::RenderableList(mir::compositor::CompositorID id));
+    MOCK_METHOD5(set_keymap, void(MirInputDeviceId, std::string const&, std::string const&,
+                                  std::string const&, std::string const&));
 };
 
 class MirSurfaceTest : public ::testing::Test
@@ -189,3 +192,78 @@ TEST_F(MirSurfaceTest, failedSurfaceCloseEventuallyDestroysSurface)
     surface.setLive(false);
     surface.unregisterView(view);
 }
+
+/*
+ * Test that the keymap is only handed to Mir (which compiles it each time) once the surface is
+ * focused, and not again while it doesn't change.
+ */
+TEST_F(MirSurfaceTest, keymapIsAppliedWhenFocusedAndOnlyOnce)
+{
+    auto mockSurface = std::make_shared<NiceMock<MockSurface>>();
+    miral::Window mockWindow(stubSession, mockSurface);
+    ms::SurfaceCreationParameters spec;
+    miral::WindowInfo mockWindowInfo(mockWindow, spec);
+    StubWindowModelController controller;
+
+    qtmir::MirSurface surface(mockWindowInfo, &controller);
+
+    EXPECT_CALL(*mockSurface, set_keymap(_, _, _, _, _))
+        .Times(0);
+
+    surface.setKeymap("us");
+    surface.setKeymap("fr+azerty");
+
+    Mock::VerifyAndClearExpectations(mockSurface.get());
+    EXPECT_CALL(*mockSurface, set_keymap(_, "", "fr", "azerty", ""))
+        .Times(1);
+
+    surface.setFocused(true);
+
+    Mock::VerifyAndClearExpectations(mockSurface.get());
+    EXPECT_CALL(*mockSurface, set_keymap(_, _, _, _, _))
+        .Times(0);
+
+    surface.setFocused(false);
+    surface.setFocused(true);
+
+    Mock::VerifyAndClearExpectations(mockSurface.get());
+    EXPECT_CALL(*mockSurface, set_keymap(_, "", "de", "", ""))
+        .Times(1);
+
+    surface.setKeymap("de");
+}
+
+/*
+ * Test that a client's surface modifications reach the MirSurface as one batch of changes
+ * and are all applied from it.
+ */
+TEST_F(MirSurfaceTest, surfaceModificationsAreDeliveredAsOneBatch)
+{
+    miral::Window mockWindow(stubSession, stubSurface);
+    ms::SurfaceCreationParameters spec;
+    miral::WindowInfo mockWindowInfo(mockWindow, spec);
+
+    qtmir::MirSurface surface(mockWindowInfo, nullptr);
+
+    QSignalSpy changesPendingSpy(surface.surfaceObserver().get(), SIGNAL(changesPending()));
+    QSignalSpy minimumWidthSpy(&surface, SIGNAL(minimumWidthChanged(int)));
+    QSignalSpy maximumHeightSpy(&surface, SIGNAL(maximumHeightChanged(int)));
+    QSignalSpy nameSpy(&surface, SIGNAL(nameChanged(QString)));
+
+    miral::WindowSpecification modifications;
+    modifications.min_width() = mir::geometry::Width{100};
+    modifications.max_height() = mir::geometry::Height{600};
+    modifications.name() = std::string("Renamed");
+    surface.surfaceObserver()->notifySurfaceModifications(modifications);
+
+    EXPECT_EQ(1, changesPendingSpy.count());
+    EXPECT_EQ(1, minimumWidthSpy.count());
+    EXPECT_EQ(1, maximumHeightSpy.count());
+    EXPECT_EQ(1, nameSpy.count());
+    EXPECT_EQ(100, surface.minimumWidth());
+    EXPECT_EQ(600, surface.maximumHeight());
+    EXPECT_EQ(QString("Renamed"), surface.name());
+
+    // Everything was collected in that one delivery
+    EXPECT_TRUE(surface.surfaceObserver()->takeChanges().isEmpty());
+}
@@ -165,6 +165,35 @@ TEST_F(WindowModelTest, WhenAddWindowNotifiedModelEmitsCountChangedSignal)
     EXPECT_EQ(1, spyCountChanged.count());
 }
 
+/*
+ * Test: that changes notified between beginChanges() and endChanges() are applied together,
+ * in order, with a single countChanged signal
+ */
+TEST_F(WindowModelTest, ChangesNotifiedInOneTransactionAreAppliedTogether)
+{
+    WindowModelNotifier notifier;
+    WindowModel model(&notifier, nullptr); // no need for controller in this testcase
+
+    auto newWindow1 = createNewWindow();
+    auto newWindow2 = createNewWindow();
+
+    QSignalSpy spyCountChanged(&model, SIGNAL(countChanged()));
+
+    notifier.beginChanges();
+    notifier.notifyWindowAdded(newWindow1);
+    notifier.notifyWindowAdded(newWindow2);
+    notifier.notifyWindowsRaised({newWindow1.windowInfo.window()});
+    notifier.endChanges();
+
+    EXPECT_EQ(0, model.count()); // nothing delivered until the event loop runs
+    flushEvents();
+
+    EXPECT_EQ(1, spyCountChanged.count());
+    ASSERT_EQ(2, model.count());
+    EXPECT_EQ(newWindow1.windowInfo.window(), getMirALWindowFromModel(model, 1));
+    EXPECT_EQ(newWindow2.windowInfo.window(), getMirALWindowFromModel(model, 0));
+}
+
 /*
  * Test: that the WindowModelNotifier.windowAdded causes the Qt-side WindowModel to
  * gain an entry which has the correct miral::Window
@@ -520,6 +549,64 @@ TEST_F(WindowModelTest, With3WindowsRaising2BottomWindowsInSwappedOrderReordersT
     EXPECT_EQ(newWindow3.windowInfo.window(), bottomWindow);
 }
 
+/*
+ * Test: raising a contiguous run of windows in their current order is a single row move
+ */
+TEST_F(WindowModelTest, RaisingContiguousWindowsInOrderIsASingleMove)
+{
+    WindowModelNotifier notifier;
+    WindowModel model(&notifier, nullptr); // no need for controller in this testcase
+
+    auto newWindow1 = createNewWindow();
+    auto newWindow2 = createNewWindow();
+    auto newWindow3 = createNewWindow();
+    notifier.windowAdded(newWindow1);
+    notifier.windowAdded(newWindow2);
+    notifier.windowAdded(newWindow3);
+    flushEvents();
+
+    QSignalSpy spyRowsMoved(&model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    QSignalSpy spyLayoutChanged(&model, SIGNAL(layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)));
+
+    notifier.windowsRaised({newWindow1.windowInfo.window(), newWindow2.windowInfo.window()});
+    flushEvents();
+
+    EXPECT_EQ(1, spyRowsMoved.count());
+    EXPECT_EQ(0, spyLayoutChanged.count());
+    EXPECT_EQ(newWindow2.windowInfo.window(), getMirALWindowFromModel(model, 2));
+    EXPECT_EQ(newWindow1.windowInfo.window(), getMirALWindowFromModel(model, 1));
+    EXPECT_EQ(newWindow3.windowInfo.window(), getMirALWindowFromModel(model, 0));
+}
+
+/*
+ * Test: a raise that reorders more than one run of windows is a single layout change
+ */
+TEST_F(WindowModelTest, RaisingWindowsOutOfOrderIsASingleLayoutChange)
+{
+    WindowModelNotifier notifier;
+    WindowModel model(&notifier, nullptr); // no need for controller in this testcase
+
+    auto newWindow1 = createNewWindow();
+    auto newWindow2 = createNewWindow();
+    auto newWindow3 = createNewWindow();
+    notifier.windowAdded(newWindow1);
+    notifier.windowAdded(newWindow2);
+    notifier.windowAdded(newWindow3);
+    flushEvents();
+
+    QSignalSpy spyRowsMoved(&model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    QSignalSpy spyLayoutChanged(&model, SIGNAL(layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)));
+
+    notifier.windowsRaised({newWindow2.windowInfo.window(), newWindow1.windowInfo.window()});
+    flushEvents();
+
+    EXPECT_EQ(0, spyRowsMoved.count());
+    EXPECT_EQ(1, spyLayoutChanged.count());
+    EXPECT_EQ(newWindow1.windowInfo.window(), getMirALWindowFromModel(model, 2));
+    EXPECT_EQ(newWindow2.windowInfo.window(), getMirALWindowFromModel(model, 1));
+    EXPECT_EQ(newWindow3.windowInfo.window(), getMirALWindowFromModel(model, 0));
+}
+
 /*
  * Test: MirSurface has inital position set correctly from miral::WindowInfo
  */